@@ -0,0 +1,207 @@
+/*
+This file maps the font partition and turns its entries into LVGL fonts
+Glyph descriptors, bitmaps and unicode lists are read straight from flash through the cache,
+only the small font and cmap descriptors live in RAM. A missing or damaged partition falls back
+to the fonts compiled into the app with ASSET_BUILTIN_FONTS, or to LVGL's default font without it.
+
+Blob layout, all little endian and 4 byte aligned:
+  AssetHeader, AssetFont[count], then the tables the entries point at
+  offsets are from the start of the blob, the crc covers everything after the header
+*/
+
+#include "string.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "esp_rom_crc.h"
+#include "asset_store.h"
+#if ASSET_BUILTIN_FONTS
+#include "fonts/fonts.h"
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;    //number of AssetFont entries
+    uint32_t size;     //whole blob including this header
+    uint32_t crc;
+} AssetHeader;
+
+typedef struct {
+    char name[12];
+    uint8_t line_height;
+    uint8_t base_line;
+    uint8_t bpp;
+    uint8_t cmap_num;
+    int8_t underline_position;
+    uint8_t underline_thickness;
+    uint16_t glyph_num;
+    uint32_t glyph_dsc_ofs; //lv_font_fmt_txt_glyph_dsc_t[glyph_num], used in place
+    uint32_t cmap_ofs;      //AssetCmap[cmap_num]
+    uint32_t bitmap_ofs;
+} AssetFont;
+
+typedef struct {
+    uint32_t range_start;
+    uint16_t range_length;
+    uint16_t glyph_id_start;
+    uint16_t list_length;
+    uint8_t type;           //lv_font_fmt_txt_cmap_type_t
+    uint8_t reserved;
+    uint32_t unicode_ofs;   //uint16_t[list_length] for sparse maps, 0 otherwise
+} AssetCmap;
+
+_Static_assert(sizeof(AssetHeader) == 16, "AssetHeader must match tools/asset_pack.py");
+_Static_assert(sizeof(AssetFont) == 32, "AssetFont must match tools/asset_pack.py");
+_Static_assert(sizeof(AssetCmap) == 16, "AssetCmap must match tools/asset_pack.py");
+_Static_assert(sizeof(lv_font_fmt_txt_glyph_dsc_t) == 8, "glyph descriptors are mapped as packed by tools/asset_pack.py");
+
+//LVGL side of one mapped font
+typedef struct {
+    lv_font_t font;
+    lv_font_fmt_txt_dsc_t dsc;
+    lv_font_fmt_txt_cmap_t cmaps[ASSET_MAX_CMAPS];
+    lv_font_fmt_txt_glyph_cache_t cache;
+} MappedFont;
+
+//Static variables
+static const char *font_names[ASSET_FONT_COUNT] = {"text", "symbols"};
+#if ASSET_BUILTIN_FONTS
+static const lv_font_t *builtin[ASSET_FONT_COUNT] = {&jetbrains_mono_16, &weather_symbols};
+#define FALLBACK_NAME "built in fonts"
+#else
+static const lv_font_t *builtin[ASSET_FONT_COUNT] = {LV_FONT_DEFAULT, LV_FONT_DEFAULT};
+#define FALLBACK_NAME "the LVGL default font"
+#endif
+static MappedFont mapped[ASSET_FONT_COUNT];
+static const lv_font_t *fonts[ASSET_FONT_COUNT];
+static const uint8_t *blob = NULL;
+static esp_partition_mmap_handle_t map_handle;
+
+static bool in_blob(uint32_t ofs, uint32_t len, uint32_t size){
+    return ofs <= size && len <= size - ofs;
+}
+
+//Checks every offset of one entry before LVGL is allowed to follow it
+static bool font_valid(const AssetFont *entry, uint32_t size){
+    if(entry->bpp != 1 && entry->bpp != 2 && entry->bpp != 4 && entry->bpp != 8){
+        return false;
+    }
+    if(entry->cmap_num == 0 || entry->cmap_num > ASSET_MAX_CMAPS){
+        return false;
+    }
+    if(!in_blob(entry->glyph_dsc_ofs, entry->glyph_num * sizeof(lv_font_fmt_txt_glyph_dsc_t), size)
+        || !in_blob(entry->cmap_ofs, entry->cmap_num * sizeof(AssetCmap), size)
+        || entry->bitmap_ofs > size){
+        return false;
+    }
+    const lv_font_fmt_txt_glyph_dsc_t *glyphs = (const void*)(blob + entry->glyph_dsc_ofs);
+    for(uint16_t i = 0; i < entry->glyph_num; ++i){
+        uint32_t bytes = (glyphs[i].box_w * glyphs[i].box_h * entry->bpp + 7) / 8;
+        if(!in_blob(entry->bitmap_ofs + glyphs[i].bitmap_index, bytes, size)){
+            return false;
+        }
+    }
+    const AssetCmap *cmaps = (const void*)(blob + entry->cmap_ofs);
+    for(uint8_t i = 0; i < entry->cmap_num; ++i){
+        //Only the tiny maps are packed, the full ones would need glyph id lists as well
+        bool sparse = cmaps[i].type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY;
+        if((!sparse && cmaps[i].type != LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY)
+            || (sparse && !in_blob(cmaps[i].unicode_ofs, cmaps[i].list_length * 2, size))
+            || cmaps[i].glyph_id_start > entry->glyph_num){
+            return false;
+        }
+    }
+    return true;
+}
+
+//Builds the RAM descriptors around the mapped tables, glyphs it lacks come from the fallback font
+static void font_load(MappedFont *out, const AssetFont *entry, const lv_font_t *fallback){
+    const AssetCmap *cmaps = (const void*)(blob + entry->cmap_ofs);
+    memset(out, 0, sizeof(*out));
+    for(uint8_t i = 0; i < entry->cmap_num; ++i){
+        out->cmaps[i].range_start = cmaps[i].range_start;
+        out->cmaps[i].range_length = cmaps[i].range_length;
+        out->cmaps[i].glyph_id_start = cmaps[i].glyph_id_start;
+        out->cmaps[i].list_length = cmaps[i].list_length;
+        out->cmaps[i].type = cmaps[i].type;
+        out->cmaps[i].unicode_list = cmaps[i].unicode_ofs ? (const void*)(blob + cmaps[i].unicode_ofs) : NULL;
+    }
+    out->dsc.glyph_bitmap = blob + entry->bitmap_ofs;
+    out->dsc.glyph_dsc = (const void*)(blob + entry->glyph_dsc_ofs);
+    out->dsc.cmaps = out->cmaps;
+    out->dsc.cmap_num = entry->cmap_num;
+    out->dsc.bpp = entry->bpp;
+    out->dsc.cache = &out->cache;
+
+    out->font.get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    out->font.get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    out->font.line_height = entry->line_height;
+    out->font.base_line = entry->base_line;
+    out->font.subpx = LV_FONT_SUBPX_NONE;
+    out->font.underline_position = entry->underline_position;
+    out->font.underline_thickness = entry->underline_thickness;
+    out->font.dsc = &out->dsc;
+    out->font.fallback = fallback;
+}
+
+//Maps the asset partition, every font not found in it stays on the fallback
+esp_err_t asset_store_init(){
+    for(int i = 0; i < ASSET_FONT_COUNT; ++i){
+        fonts[i] = builtin[i];
+    }
+
+    const esp_partition_t *part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ASSET_SUBTYPE, ASSET_PARTITION);
+    if(part == NULL){
+        ESP_LOGE("ASSET", "No asset partition, using " FALLBACK_NAME);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    AssetHeader header;
+    esp_err_t err = esp_partition_read(part, 0, &header, sizeof(header));
+    if(err != ESP_OK || header.magic != ASSET_MAGIC){
+        ESP_LOGE("ASSET", "Asset partition is empty, using " FALLBACK_NAME);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if(header.version != ASSET_FORMAT_VERSION || header.size < sizeof(header) || header.size > part->size
+        || header.count * sizeof(AssetFont) > header.size - sizeof(header)){
+        ESP_LOGE("ASSET", "Unsupported asset blob, version %d size %lu", header.version, header.size);
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    const void *ptr;
+    err = esp_partition_mmap(part, 0, header.size, ESP_PARTITION_MMAP_DATA, &ptr, &map_handle);
+    if(err != ESP_OK){
+        ESP_LOGE("ASSET", "mmap failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    blob = ptr;
+
+    if(esp_rom_crc32_le(0, blob + sizeof(header), header.size - sizeof(header)) != header.crc){
+        ESP_LOGE("ASSET", "Asset blob crc mismatch, using " FALLBACK_NAME);
+        esp_partition_munmap(map_handle);
+        blob = NULL;
+        return ESP_ERR_INVALID_CRC;
+    }
+
+    const AssetFont *entries = (const void*)(blob + sizeof(header));
+    for(uint16_t e = 0; e < header.count; ++e){
+        for(int i = 0; i < ASSET_FONT_COUNT; ++i){
+            if(strncmp(entries[e].name, font_names[i], sizeof(entries[e].name)) != 0){
+                continue;
+            }
+            if(!font_valid(&entries[e], header.size)){
+                ESP_LOGE("ASSET", "Font %s is malformed, keeping " FALLBACK_NAME, font_names[i]);
+                break;
+            }
+            font_load(&mapped[i], &entries[e], builtin[i]);
+            fonts[i] = &mapped[i].font;
+            ESP_LOGI("ASSET", "Font %s mapped, %d glyphs", font_names[i], entries[e].glyph_num);
+        }
+    }
+    return ESP_OK;
+}
+
+//Font to use for a UI element, valid before asset_store_init as well
+const lv_font_t* asset_font(AssetFontId id){
+    return fonts[id] != NULL ? fonts[id] : builtin[id];
+}
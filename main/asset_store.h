@@ -0,0 +1,30 @@
+#ifndef asset_store
+#define asset_store
+
+#include "stdint.h"
+#include "esp_err.h"
+#include "lvgl.h"
+
+//Partition holding the font blob, see partitions.csv and tools/asset_pack.py
+#define ASSET_PARTITION "assets"
+#define ASSET_SUBTYPE 0x41
+#define ASSET_MAGIC 0x31534157 //"WAS1"
+#define ASSET_FORMAT_VERSION 1
+#define ASSET_MAX_CMAPS 4
+
+//1 links the fonts of main/fonts into the app as the fallback for a missing or damaged partition
+//0 leaves them out of the image (nothing else references them) and falls back to LV_FONT_DEFAULT,
+//which has none of the weather symbols, so the assets partition has to be flashed
+#define ASSET_BUILTIN_FONTS 0
+
+//Fonts the UI asks for, the fallback is used when the partition has none
+typedef enum {
+    ASSET_FONT_TEXT,
+    ASSET_FONT_SYMBOLS,
+    ASSET_FONT_COUNT
+} AssetFontId;
+
+esp_err_t asset_store_init();
+const lv_font_t* asset_font(AssetFontId id);
+
+#endif // asset_store
@@ -0,0 +1,152 @@
+/*
+This file buffers the binary log records and sends them out over the UART in the background
+Writers claim a slot with one atomic add and publish it by storing its sequence number last,
+so any task or core can log without a lock. Only the drain task reads the ring, when writers
+lap it the oldest records are counted as dropped.
+
+Record on the wire: BLOG_MAGIC, id, argument count, 0, timestamp in ms, arguments, little endian,
+with 0x0A and BLOG_ESC escaped after the magic byte (see blog.h)
+*/
+
+#include "stdio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "metrics.h"
+#include "blog.h"
+
+#define BLOG_HEADER_BYTES 8
+#define BLOG_BENCH_CALLS 20
+#define BLOG_RECORD_MAX (2 * (BLOG_HEADER_BYTES + BLOG_MAX_ARGS * sizeof(uint32_t))) //every byte escaped
+
+typedef struct {
+    uint32_t seq;        //index + 1 once the slot is complete, 0 while it is written
+    uint8_t id;
+    uint8_t nargs;
+    uint16_t reserved;
+    uint32_t time_ms;
+    uint32_t args[BLOG_MAX_ARGS];
+} BlogSlot;
+
+//Static variables
+static BlogSlot ring[BLOG_SLOTS];
+static uint32_t head = 0;   //next index to claim
+static uint32_t tail = 0;   //next index to drain, drain task only
+static uint8_t out[BLOG_SLOTS / 4 * BLOG_RECORD_MAX];
+
+//Stores one record, safe from any task and from ISRs
+void blog_write(BlogId id, uint8_t nargs, const uint32_t *args){
+    uint32_t index = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+    BlogSlot *slot = &ring[index % BLOG_SLOTS];
+    __atomic_store_n(&slot->seq, 0, __ATOMIC_RELAXED);
+    slot->id = id;
+    slot->nargs = nargs > BLOG_MAX_ARGS ? BLOG_MAX_ARGS : nargs;
+    slot->time_ms = esp_timer_get_time() / 1000;
+    memcpy(slot->args, args, slot->nargs * sizeof(uint32_t));
+    __atomic_store_n(&slot->seq, index + 1, __ATOMIC_RELEASE);
+    app_metrics.blog_records++;
+}
+
+//Appends one record to out, returns the new length
+static size_t encode(size_t len, uint8_t id, uint8_t nargs, uint32_t time_ms, const uint32_t *args){
+    uint8_t record[BLOG_HEADER_BYTES + BLOG_MAX_ARGS * sizeof(uint32_t)]; //everything after the magic byte
+    size_t size = BLOG_HEADER_BYTES - 1 + nargs * sizeof(uint32_t);
+    record[0] = id;
+    record[1] = nargs;
+    record[2] = 0;
+    memcpy(&record[3], &time_ms, sizeof(time_ms));
+    memcpy(&record[BLOG_HEADER_BYTES - 1], args, nargs * sizeof(uint32_t));
+
+    out[len++] = BLOG_MAGIC;
+    for(size_t i = 0; i < size; ++i){
+        if(record[i] == '\n' || record[i] == BLOG_ESC){
+            out[len++] = BLOG_ESC;
+            out[len++] = record[i] == '\n' ? 0xDC : 0xDD;
+        }
+        else{
+            out[len++] = record[i];
+        }
+    }
+    return len;
+}
+
+static size_t flush_out(size_t len){
+    if(len > 0){
+        fwrite(out, 1, len, stdout);
+        fflush(stdout);
+        app_metrics.blog_bytes += len;
+    }
+    return 0;
+}
+
+//Sends every complete record, stops at the first one still being written
+void blog_drain(){
+    size_t len = 0;
+    uint32_t dropped = 0;
+    while(tail != __atomic_load_n(&head, __ATOMIC_ACQUIRE)){
+        uint32_t claimed = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+        if(claimed - tail > BLOG_SLOTS){ //lapped, those slots hold newer records now
+            dropped += claimed - BLOG_SLOTS - tail;
+            tail = claimed - BLOG_SLOTS;
+        }
+        BlogSlot *slot = &ring[tail % BLOG_SLOTS];
+        if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail + 1){
+            if(claimed - tail < BLOG_SLOTS){
+                break; //still being written
+            }
+            dropped++;
+            tail++;
+            continue;
+        }
+        BlogSlot copy = *slot;
+        if(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail + 1){ //overwritten while copying
+            dropped++;
+            tail++;
+            continue;
+        }
+        if(len + BLOG_RECORD_MAX > sizeof(out)){
+            len = flush_out(len);
+        }
+        len = encode(len, copy.id, copy.nargs, copy.time_ms, copy.args);
+        tail++;
+    }
+    if(dropped > 0){
+        app_metrics.blog_dropped += dropped;
+        len = encode(len, BLOG_DROPPED, 1, esp_timer_get_time() / 1000, &dropped);
+    }
+    flush_out(len);
+}
+
+void blog_drain_task(void *parameter){
+    while(1){
+        blog_drain();
+        app_metrics.task_wakeups++;
+        vTaskDelay(BLOG_DRAIN_MS / portTICK_PERIOD_MS);
+    }
+}
+
+//Times the same record through ESP_LOGI and BLOG and logs the cost and UART bytes of each
+void blog_bench(){
+    int64_t start_us = esp_timer_get_time();
+    for(int i = 0; i < BLOG_BENCH_CALLS; ++i){
+        ESP_LOGI("BLOG", "Bench %d: temp %.1f", i, 71.5f);
+    }
+    int64_t text_us = (esp_timer_get_time() - start_us) / BLOG_BENCH_CALLS;
+    char line[64];
+    int text_bytes = snprintf(line, sizeof(line), "I (%lu) BLOG: Bench %d: temp %.1f\n",
+        esp_log_timestamp(), BLOG_BENCH_CALLS - 1, 71.5f);
+#if CONFIG_LOG_COLORS
+    text_bytes += 11; //color start and reset sequences
+#endif
+
+    start_us = esp_timer_get_time();
+    for(int i = 0; i < BLOG_BENCH_CALLS; ++i){
+        BLOG(BLOG_BENCH, i, blog_f(71.5f));
+    }
+    int64_t binary_us = (esp_timer_get_time() - start_us) / BLOG_BENCH_CALLS;
+    blog_drain();
+
+    ESP_LOGI("BLOG", "Per call: ESP_LOGI %lld us, %d UART bytes. BLOG %lld us, %d UART bytes",
+        text_us, text_bytes, binary_us, BLOG_HEADER_BYTES + 2 * (int)sizeof(uint32_t));
+}
@@ -0,0 +1,54 @@
+#ifndef blog
+#define blog
+
+#include "stdint.h"
+#include "string.h"
+
+//Deferred binary log for hot paths: a record is the format id, a timestamp and raw 32 bit
+//arguments, text is rebuilt on the host with tools/blog_decode.py from the table below
+//X(id, tag, format), ids are the position in the table so only append to it
+#define BLOG_FORMATS(X) \
+    X(BLOG_DROPPED,       "BLOG", "%u records dropped") \
+    X(BLOG_LVGL_DATA_LEN, "LVGL", "Data Length:%d") \
+    X(BLOG_LVGL_TIME,     "LVGL", "Updating the Time and Date") \
+    X(BLOG_LVGL_WEATHER,  "LVGL", "Updating the Weather Info") \
+    X(BLOG_LVGL_FORECAST, "LVGL", "Updating the Forecast") \
+    X(BLOG_TIME_NOW,      "TIME", "Current time: %02d-%02d-%04d %02d:%02d:%02d") \
+    X(BLOG_WIFI_RSSI,     "WiFi", "Connected to Wi-Fi. Signal strength: %d") \
+    X(BLOG_WIFI_DOWN,     "WiFi", "Not connected to Wi-Fi.") \
+    X(BLOG_BENCH,         "BLOG", "Bench %d: temp %.1f")
+
+#define BLOG_ID(id, tag, fmt) id,
+typedef enum {
+    BLOG_FORMATS(BLOG_ID)
+    BLOG_FORMAT_COUNT
+} BlogId;
+#undef BLOG_ID
+
+#define BLOG_SLOTS 64      //records buffered between drains, older ones are dropped
+#define BLOG_MAX_ARGS 6
+#define BLOG_MAGIC 0xB7    //first byte of every record on the UART
+//The console turns every 0x0A it prints into CR LF, so records never carry one:
+//0x0A goes out as BLOG_ESC 0xDC and BLOG_ESC itself as BLOG_ESC 0xDD
+#define BLOG_ESC 0xDB
+#define BLOG_DRAIN_MS 1000
+//1 compares BLOG against ESP_LOGI for one record at boot
+#define BLOG_BENCH_ENABLE 0
+
+//BLOG(BLOG_TIME_NOW, day, month, ...), integers are passed as is, floats through blog_f()
+#define BLOG_ARGS(...) ((const uint32_t[]){__VA_ARGS__})
+#define BLOG(id, ...) blog_write(id, sizeof(BLOG_ARGS(0, ##__VA_ARGS__)) / sizeof(uint32_t) - 1, \
+    BLOG_ARGS(0, ##__VA_ARGS__) + 1)
+
+static inline uint32_t blog_f(float value){
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+void blog_write(BlogId id, uint8_t nargs, const uint32_t *args);
+void blog_drain();
+void blog_drain_task(void *parameter);
+void blog_bench();
+
+#endif // blog
@@ -0,0 +1,159 @@
+/*
+This file draws the clock without going through LVGL text rendering
+At boot the clock glyphs are rasterized once into columns in the panel's page layout,
+after that a time change only copies the columns of the cells that changed into the
+now page framebuffer and sends that span to the panel.
+LVGL does not know about these pixels, so whenever it flushes an area over the clock
+the cells are copied back before the area goes out.
+*/
+
+#include "string.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "page_cache.h"
+#include "panel_bus.h"
+#include "metrics.h"
+#include "digit_clock.h"
+
+#define GLYPH_COUNT (sizeof(CLOCK_GLYPHS) - 1)
+#define LIT_THRESHOLD 8 //4bpp coverage that counts as a lit pixel
+
+//Static variables
+static uint8_t atlas[GLYPH_COUNT][CLOCK_PAGES][CLOCK_CELL_MAX_W];
+static uint8_t cell_w = 0;
+static char shown[CLOCK_CELLS + 1] = "";
+
+static int glyph_index(char c){
+    const char *found = strchr(CLOCK_GLYPHS, c);
+    return (found != NULL && c != '\0') ? found - CLOCK_GLYPHS : -1;
+}
+
+//Thresholds one glyph of font into packed columns, false when it does not fit a cell
+static bool rasterize(const lv_font_t *font, char c, uint8_t cols[CLOCK_PAGES][CLOCK_CELL_MAX_W]){
+    lv_font_glyph_dsc_t dsc;
+    if(!lv_font_get_glyph_dsc(font, &dsc, c, '\0') || dsc.adv_w != cell_w){
+        return false;
+    }
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, c);
+    int top = (font->line_height - font->base_line) - dsc.box_h - dsc.ofs_y;
+    uint8_t bpp = dsc.bpp;
+    uint8_t mask = (1 << bpp) - 1;
+    for(int gy = 0; gy < dsc.box_h; ++gy){
+        for(int gx = 0; gx < dsc.box_w; ++gx){
+            uint32_t bit = (gy * dsc.box_w + gx) * bpp;
+            uint8_t value = (bitmap[bit >> 3] >> (8 - bpp - (bit & 7))) & mask;
+            if(value * 15 / mask < LIT_THRESHOLD){
+                continue;
+            }
+            int x = dsc.ofs_x + gx;
+            int y = top + gy;
+            if(x < 0 || x >= cell_w || y < 0 || y >= CLOCK_PAGES * 8){
+                return false;
+            }
+            cols[y >> 3][x] |= 1 << (y & 7);
+        }
+    }
+    return true;
+}
+
+//Copies cells [first, last] of shown into the framebuffer
+static void draw_cells(uint8_t *fb, int first, int last){
+    for(int i = first; i <= last; ++i){
+        int g = glyph_index(shown[i]);
+        for(int p = 0; p < CLOCK_PAGES; ++p){
+            uint8_t *dst = &fb[p * PAGE_H_RES + CLOCK_X + i * cell_w];
+            if(g < 0){
+                memset(dst, 0, cell_w);
+            }
+            else{
+                memcpy(dst, atlas[g][p], cell_w);
+            }
+        }
+    }
+}
+
+//Puts the cells back after LVGL redrew anything on top of them, before the area is sent
+static void clock_overlay(uint8_t *fb, const lv_area_t *area){
+    int len = strlen(shown);
+    if(len == 0 || (area->y1 >> 3) >= CLOCK_PAGES || area->x1 >= CLOCK_X + len * cell_w || area->x2 < CLOCK_X){
+        return;
+    }
+    int first = (area->x1 - CLOCK_X) / cell_w;
+    int last = (area->x2 - CLOCK_X) / cell_w;
+    draw_cells(fb, first < 0 ? 0 : first, last >= len ? len - 1 : last);
+}
+
+//Builds the atlas from the text font, false leaves the label based clock in charge
+bool digit_clock_init(const lv_font_t *font){
+    lv_font_glyph_dsc_t dsc;
+    if(!lv_font_get_glyph_dsc(font, &dsc, '0', '\0') || dsc.adv_w > CLOCK_CELL_MAX_W
+        || CLOCK_X + CLOCK_CELLS * dsc.adv_w > PAGE_H_RES){
+        ESP_LOGW("CLOCK", "Font does not fit the atlas");
+        return false;
+    }
+    cell_w = dsc.adv_w;
+    memset(atlas, 0, sizeof(atlas));
+    for(int g = 0; g < GLYPH_COUNT; ++g){
+        if(!rasterize(font, CLOCK_GLYPHS[g], atlas[g])){
+            ESP_LOGW("CLOCK", "Glyph '%c' does not fit a %dx%d cell", CLOCK_GLYPHS[g], cell_w, CLOCK_PAGES * 8);
+            cell_w = 0;
+            return false;
+        }
+    }
+    page_cache_set_overlay(PAGE_NOW, clock_overlay);
+    ESP_LOGI("CLOCK", "Atlas ready, %d glyphs of %dx%d", GLYPH_COUNT, cell_w, CLOCK_PAGES * 8);
+    return true;
+}
+
+//Shows text, only the span between the first and last changed cell is copied and sent
+//Call with the LVGL lock, the framebuffer is shared with LVGL rendering
+void digit_clock_set(const char *text){
+    int64_t start_us = esp_timer_get_time();
+    uint32_t bytes_before = app_metrics.panel_bytes;
+    uint64_t bus_before = app_metrics.panel_bus_us;
+    int len = strnlen(text, CLOCK_CELLS);
+    int old_len = strlen(shown);
+    int cells = len > old_len ? len : old_len;
+    int first = -1;
+    int last = -1;
+    for(int i = 0; i < cells; ++i){
+        char c = i < len ? text[i] : '\0';
+        if(shown[i] != c){
+            if(first < 0){
+                first = i;
+            }
+            last = i;
+        }
+    }
+    memcpy(shown, text, len);
+    memset(shown + len, 0, sizeof(shown) - len);
+    if(first < 0){
+        return;
+    }
+
+    uint8_t *fb = page_cache_fb(PAGE_NOW);
+    draw_cells(fb, first, last);
+    page_cache_send(PAGE_NOW, CLOCK_X + first * cell_w, 0, CLOCK_X + (last + 1) * cell_w - 1, CLOCK_PAGES - 1);
+
+    app_metrics.clock_render_us = esp_timer_get_time() - start_us;
+    app_metrics.clock_bytes = app_metrics.panel_bytes - bytes_before;
+    app_metrics.clock_bus_us = app_metrics.panel_bus_us - bus_before;
+    if(app_metrics.clock_render_us > app_metrics.clock_render_max_us){
+        app_metrics.clock_render_max_us = app_metrics.clock_render_us;
+    }
+}
+
+//Checks the last change against the per second budget, only meaningful for seconds-only changes
+void digit_clock_check_budget(){
+    if(app_metrics.clock_render_us <= CLOCK_SECOND_CPU_US && app_metrics.clock_bus_us <= CLOCK_SECOND_BUS_US
+        && app_metrics.clock_bytes <= CLOCK_SECOND_BYTES){
+        return;
+    }
+    app_metrics.clock_overruns++;
+    ESP_LOGW("CLOCK", "Second over budget: %lu us CPU, %lu us bus, %lu bytes",
+        app_metrics.clock_render_us, app_metrics.clock_bus_us, app_metrics.clock_bytes);
+#if CLOCK_BUDGET_STRICT
+    configASSERT(0);
+#endif
+}
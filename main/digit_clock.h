@@ -0,0 +1,34 @@
+#ifndef digit_clock
+#define digit_clock
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "lvgl.h"
+#include "panel_bus.h"
+
+//1 draws the clock from a 1bpp atlas straight into the now page framebuffer instead of the time label
+#define DIGIT_CLOCK 1
+//1 times one minute change through the label and through the atlas at boot and logs both
+#define DIGIT_CLOCK_BENCH 0
+
+//1 shows HH:MM:SS in 24 hour time, redrawn right after every second boundary
+#define CLOCK_SECONDS 0
+//Budget of a change that only touches the seconds, two cells on CLOCK_PAGES pages
+//The bus side is what panel_bus.c charges for it, at 400 kHz about 1.65 ms and 72 bytes
+#define CLOCK_SECOND_CPU_US 2000
+#define CLOCK_SECOND_BUS_US (CLOCK_PAGES * PANEL_DRAW_US(2 * CLOCK_CELL_MAX_W))
+#define CLOCK_SECOND_BYTES (CLOCK_PAGES * PANEL_DRAW_BYTES(2 * CLOCK_CELL_MAX_W))
+#define CLOCK_BUDGET_STRICT 0 //1 asserts on an overrun instead of counting it
+
+//Characters kept in the atlas and the area the clock owns on the now page
+#define CLOCK_GLYPHS "0123456789:AMP"
+#define CLOCK_CELLS 8        //longest clock string
+#define CLOCK_CELL_MAX_W 12  //widest advance the atlas accepts
+#define CLOCK_PAGES 2        //glyphs must fit in the top 16 rows
+#define CLOCK_X 0
+
+bool digit_clock_init(const lv_font_t *font);
+void digit_clock_set(const char *text);
+void digit_clock_check_budget();
+
+#endif // digit_clock
@@ -0,0 +1,115 @@
+/*
+This file keeps the resolved addresses of the API and NTP hosts
+Entries are persisted in NVS, served stale when resolving fails,
+and refreshed inside the network window once they expire
+*/
+
+#include "dns_cache.h"
+#include "metrics.h"
+#include "string.h"
+#include "time.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "lwip/netdb.h"
+
+#define DNS_CACHE_NS "dns_cache"
+#define DNS_CACHE_KEY "entries"
+#define VALID_EPOCH 1700000000 //anything earlier means the clock is not synced yet
+
+typedef struct {
+    char host[DNS_HOST_MAX];
+    esp_ip4_addr_t addr;
+    time_t expires;
+} DnsEntry;
+
+//Static variables
+static DnsEntry entries[DNS_CACHE_SIZE];
+
+static void dns_cache_save(){
+    nvs_handle_t nvs;
+    if(nvs_open(DNS_CACHE_NS, NVS_READWRITE, &nvs) == ESP_OK){
+        nvs_set_blob(nvs, DNS_CACHE_KEY, entries, sizeof(entries));
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+//Loads the entries saved before the last reboot, NVS must already be initialized
+void dns_cache_init(){
+    nvs_handle_t nvs;
+    size_t len = sizeof(entries);
+    memset(entries, 0, sizeof(entries));
+    if(nvs_open(DNS_CACHE_NS, NVS_READONLY, &nvs) == ESP_OK){
+        if(nvs_get_blob(nvs, DNS_CACHE_KEY, entries, &len) != ESP_OK || len != sizeof(entries)){
+            memset(entries, 0, sizeof(entries));
+        }
+        nvs_close(nvs);
+    }
+}
+
+static DnsEntry* find(const char* host){
+    for(int i = 0; i < DNS_CACHE_SIZE; ++i){
+        if(strncmp(entries[i].host, host, DNS_HOST_MAX) == 0){
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static bool expired(const DnsEntry* entry){
+    time_t now = time(NULL);
+    return now < VALID_EPOCH || now >= entry->expires;
+}
+
+//Resolves host through lwIP and stores it, the old address stays if resolving fails
+static esp_err_t resolve(const char* host, DnsEntry* entry){
+    struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM };
+    struct addrinfo *res = NULL;
+    if(getaddrinfo(host, NULL, &hints, &res) != 0 || res == NULL){
+        ESP_LOGW("DNS", "Could not resolve %s", host);
+        return ESP_FAIL;
+    }
+    struct sockaddr_in *sa = (struct sockaddr_in *)res->ai_addr;
+    strlcpy(entry->host, host, DNS_HOST_MAX);
+    entry->addr.addr = sa->sin_addr.s_addr;
+    entry->expires = time(NULL) + DNS_CACHE_TTL_S;
+    freeaddrinfo(res);
+    dns_cache_save();
+    return ESP_OK;
+}
+
+//Returns the cached address of host, resolving only when nothing is cached
+//Expired entries are still returned and get refreshed by dns_cache_refresh, they count as stale rather than hits
+esp_err_t dns_cache_lookup(const char* host, esp_ip4_addr_t* addr){
+    DnsEntry *entry = find(host);
+    if(entry != NULL){
+        if(expired(entry)){
+            app_metrics.dns_stale++;
+        }
+        else{
+            app_metrics.dns_hits++;
+        }
+        *addr = entry->addr;
+        return ESP_OK;
+    }
+
+    app_metrics.dns_misses++;
+    entry = find(""); //free slot
+    if(entry == NULL){
+        entry = &entries[0];
+    }
+    if(resolve(host, entry) != ESP_OK){
+        return ESP_FAIL;
+    }
+    *addr = entry->addr;
+    return ESP_OK;
+}
+
+//Re-resolves expired entries, a failure keeps the old address for dns_cache_lookup to serve
+void dns_cache_refresh(){
+    for(int i = 0; i < DNS_CACHE_SIZE; ++i){
+        if(entries[i].host[0] != '\0' && expired(&entries[i])){
+            resolve(entries[i].host, &entries[i]);
+        }
+    }
+}
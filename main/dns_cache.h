@@ -0,0 +1,16 @@
+#ifndef dns_cache
+#define dns_cache
+
+#include "esp_err.h"
+#include "esp_netif_ip_addr.h"
+
+//lwIP's resolver API does not expose the record TTL, so entries use this one
+#define DNS_CACHE_TTL_S (60 * 60 * 6)
+#define DNS_CACHE_SIZE 3 //API, NTP and a backup API host
+#define DNS_HOST_MAX 32
+
+void dns_cache_init();
+esp_err_t dns_cache_lookup(const char* host, esp_ip4_addr_t* addr);
+void dns_cache_refresh();
+
+#endif // dns_cache
@@ -0,0 +1,126 @@
+/*
+This file is a single task event loop: a timer wheel for periodic work
+and a queue of callbacks for render requests and fetch completions
+Only used when EVENT_LOOP_MODE is set in task_plan.h
+*/
+
+#include "event_loop.h"
+#include "metrics.h"
+#include "esp_log.h"
+
+//Static variables
+static QueueHandle_t loop_queue = NULL;
+static WheelTimer* wheel[WHEEL_SLOTS];
+static uint8_t cursor = 0;
+static TickType_t last_tick = 0;
+
+void event_loop_init(QueueHandle_t queue){
+    loop_queue = queue;
+    last_tick = xTaskGetTickCount();
+}
+
+//Queues cb to run on the loop task, safe from other tasks
+//The loop itself must pass a wait of 0, it is the only one emptying the queue. A dropped event is counted.
+bool event_post(EventCb cb, void* arg, TickType_t wait){
+    LoopEvent ev = { .cb = cb, .arg = arg };
+    if(xQueueSend(loop_queue, &ev, wait) != pdTRUE){
+        app_metrics.loop_events_dropped++;
+        ESP_LOGW("LOOP", "Queue full, event dropped");
+        return false;
+    }
+    return true;
+}
+
+static void wheel_insert(WheelTimer* timer, uint32_t delay_ms){
+    uint32_t ticks = delay_ms / WHEEL_TICK_MS;
+    if(ticks == 0){
+        ticks = 1;
+    }
+    timer->slot = (cursor + ticks) % WHEEL_SLOTS;
+    timer->rounds = (ticks - 1) / WHEEL_SLOTS;
+    timer->next = wheel[timer->slot];
+    wheel[timer->slot] = timer;
+    timer->active = true;
+}
+
+static void wheel_remove(WheelTimer* timer){
+    WheelTimer** link = &wheel[timer->slot];
+    while(*link != NULL){
+        if(*link == timer){
+            *link = timer->next;
+            break;
+        }
+        link = &(*link)->next;
+    }
+    timer->active = false;
+}
+
+//Only call from the loop task or before it starts
+void event_timer_start(WheelTimer* timer, uint32_t delay_ms, uint32_t period_ms, EventCb cb, void* arg){
+    if(timer->active){
+        wheel_remove(timer);
+    }
+    timer->cb = cb;
+    timer->arg = arg;
+    timer->period_ms = period_ms;
+    wheel_insert(timer, delay_ms);
+}
+
+void event_timer_stop(WheelTimer* timer){
+    if(timer->active){
+        wheel_remove(timer);
+    }
+}
+
+//Fires every timer due in the current slot
+static void wheel_advance(){
+    cursor = (cursor + 1) % WHEEL_SLOTS;
+    WheelTimer* timer = wheel[cursor];
+    wheel[cursor] = NULL;
+    while(timer != NULL){
+        WheelTimer* next = timer->next;
+        if(timer->rounds > 0){ //not this revolution, put it back
+            timer->rounds--;
+            timer->next = wheel[cursor];
+            wheel[cursor] = timer;
+        }
+        else{
+            timer->active = false;
+            if(timer->period_ms > 0){
+                wheel_insert(timer, timer->period_ms);
+            }
+            timer->cb(timer->arg);
+        }
+        timer = next;
+    }
+}
+
+//Number of wheel ticks until the next slot holding a timer
+static uint32_t ticks_to_next(){
+    for(uint32_t i = 1; i < WHEEL_SLOTS; ++i){
+        if(wheel[(cursor + i) % WHEEL_SLOTS] != NULL){
+            return i;
+        }
+    }
+    return WHEEL_SLOTS;
+}
+
+//Sleeps until the next occupied wheel slot or a posted event, whichever comes first
+//Ticks missed while a callback was busy are caught up one by one so no timer is skipped
+void event_loop_task(void *parameter){
+    const TickType_t tick_len = pdMS_TO_TICKS(WHEEL_TICK_MS);
+    LoopEvent ev;
+    while(1){
+        TickType_t elapsed = xTaskGetTickCount() - last_tick;
+        TickType_t due = ticks_to_next() * tick_len;
+        TickType_t wait = elapsed >= due ? 0 : due - elapsed;
+        if(xQueueReceive(loop_queue, &ev, wait) == pdTRUE){
+            ev.cb(ev.arg);
+        }
+        app_metrics.task_wakeups++;
+        while(xTaskGetTickCount() - last_tick >= tick_len){
+            last_tick += tick_len;
+            wheel_advance();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef event_loop
+#define event_loop
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+//Timer wheel resolution and size, one revolution is WHEEL_TICK_MS * WHEEL_SLOTS
+#define WHEEL_TICK_MS 100
+#define WHEEL_SLOTS 64
+
+typedef void (*EventCb)(void* arg);
+
+//Callback queued for the loop task
+typedef struct {
+    EventCb cb;
+    void* arg;
+} LoopEvent;
+
+//Timer living in one wheel slot, rounds counts the revolutions left before it fires
+typedef struct WheelTimer {
+    EventCb cb;
+    void* arg;
+    uint32_t period_ms; //0 for one shot
+    uint32_t rounds;
+    uint8_t slot;
+    bool active;
+    struct WheelTimer* next;
+} WheelTimer;
+
+void event_loop_init(QueueHandle_t queue);
+void event_loop_task(void *parameter);
+bool event_post(EventCb cb, void* arg, TickType_t wait);
+void event_timer_start(WheelTimer* timer, uint32_t delay_ms, uint32_t period_ms, EventCb cb, void* arg);
+void event_timer_stop(WheelTimer* timer);
+
+#endif // event_loop
@@ -1,6 +1,7 @@
 /*******************************************************************************
  * Size: 15 px
  * Bpp: 4
+ * Subset: 7 glyphs kept by tools/font_subset.py
  * Opts: --bpp 4 --size 15 --no-compress --font fa-solid-900.ttf --range 61713,61634,63293,63296,63322,62172,61507 --format lvgl -o weather_symbols.c
  ******************************************************************************/
 
@@ -0,0 +1,174 @@
+/*
+This file draws the last 24 hours of temperature and precipitation
+The plot is a sweep: each hour writes its own column and blanks the one after it,
+so an update only invalidates two columns instead of shifting the whole plot.
+The scale is fitted to the readings in the window, so the axis labels only change
+when a reading leaves it or the last reading at its edge is swept out.
+Black is a lit pixel on the monochrome panel.
+Call with the LVGL lock held.
+*/
+
+#include "graph_page.h"
+#include "history_log.h"
+#include "asset_store.h"
+#include "stdio.h"
+#include "string.h"
+#include "math.h"
+#include "time.h"
+
+#define GRAPH_BOTTOM 64
+#define DOT_H 2
+#define BAR_W (GRAPH_COL_W - 1)
+
+typedef struct {
+    float temp;
+    float precip;
+    bool valid;
+} GraphSample;
+
+//Static variables
+static lv_obj_t *dots[GRAPH_COLUMNS];
+static lv_obj_t *bars[GRAPH_COLUMNS];
+static lv_obj_t *max_label = NULL;
+static lv_obj_t *min_label = NULL;
+static GraphSample samples[GRAPH_COLUMNS];
+static uint8_t cursor = 0;        //column of the newest sample
+static uint32_t last_hour = 0;
+static int scale_min = 0;
+static int scale_max = 0;
+static char label_buf[6];
+
+static lv_obj_t *plot_obj(lv_obj_t *parent){
+    lv_obj_t *obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, lv_color_black(), 0);
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+    return obj;
+}
+
+static void set_label(lv_obj_t *label, int value){
+    snprintf(label_buf, sizeof(label_buf), "%d", value);
+    if(strcmp(lv_label_get_text(label), label_buf) != 0){ //same text would still invalidate
+        lv_label_set_text(label, label_buf);
+    }
+}
+
+//Places the objects of one column, only this column's area gets invalidated
+static void draw_column(uint8_t col){
+    GraphSample *s = &samples[col];
+    if(!s->valid){
+        lv_obj_add_flag(dots[col], LV_OBJ_FLAG_HIDDEN);
+        lv_obj_add_flag(bars[col], LV_OBJ_FLAG_HIDDEN);
+        return;
+    }
+    int span = scale_max - scale_min;
+    int y = GRAPH_TEMP_H - DOT_H - (int)((s->temp - scale_min) * (GRAPH_TEMP_H - DOT_H) / span);
+    lv_obj_set_pos(dots[col], col * GRAPH_COL_W, y);
+    lv_obj_clear_flag(dots[col], LV_OBJ_FLAG_HIDDEN);
+
+    int h = (int)(s->precip * GRAPH_PRECIP_H / GRAPH_PRECIP_FULL);
+    if(h > GRAPH_PRECIP_H){
+        h = GRAPH_PRECIP_H;
+    }
+    if(h > 0){
+        lv_obj_set_size(bars[col], BAR_W, h);
+        lv_obj_set_pos(bars[col], col * GRAPH_COL_W, GRAPH_BOTTOM - h);
+        lv_obj_clear_flag(bars[col], LV_OBJ_FLAG_HIDDEN);
+    }
+    else{
+        lv_obj_add_flag(bars[col], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+//Fits the scale to the readings in the window, widening or narrowing it, returns true if every column has to move
+static bool fit_scale(){
+    float low = INFINITY;
+    float high = -INFINITY;
+    for(int i = 0; i < GRAPH_COLUMNS; ++i){
+        if(samples[i].valid){
+            low = fminf(low, samples[i].temp);
+            high = fmaxf(high, samples[i].temp);
+        }
+    }
+    if(low > high){ //nothing to show
+        return false;
+    }
+    int lo = (int)floorf(low / GRAPH_TEMP_STEP) * GRAPH_TEMP_STEP;
+    int hi = (int)floorf(high / GRAPH_TEMP_STEP) * GRAPH_TEMP_STEP + GRAPH_TEMP_STEP;
+    if(lo == scale_min && hi == scale_max){
+        return false;
+    }
+    scale_min = lo;
+    scale_max = hi;
+    set_label(max_label, scale_max);
+    set_label(min_label, scale_min);
+    return true;
+}
+
+static void seed_cb(const HistoryReading *reading, void *arg){
+    graph_page_push(reading->time, reading->temp, reading->precip);
+}
+
+void graph_page_create(lv_obj_t *parent){
+    for(int i = 0; i < GRAPH_COLUMNS; ++i){
+        dots[i] = plot_obj(parent);
+        lv_obj_set_size(dots[i], BAR_W, DOT_H);
+        bars[i] = plot_obj(parent);
+    }
+
+    max_label = lv_label_create(parent);
+    lv_label_set_text(max_label, "");
+    lv_obj_align(max_label, LV_ALIGN_TOP_RIGHT, 0, 0);
+    lv_obj_set_style_text_font(max_label, asset_font(ASSET_FONT_TEXT), 0);
+
+    min_label = lv_label_create(parent);
+    lv_label_set_text(min_label, "");
+    lv_obj_align(min_label, LV_ALIGN_TOP_RIGHT, 0, GRAPH_TEMP_H - 16);
+    lv_obj_set_style_text_font(min_label, asset_font(ASSET_FONT_TEXT), 0);
+}
+
+//Fills the plot with whatever the history log has for the last day, needs the clock synced
+void graph_page_seed(){
+    time_t now = time(NULL);
+    history_log_query(now - GRAPH_COLUMNS * 3600, now, seed_cb, NULL);
+}
+
+//Adds a reading, readings within the same hour replace that hour's column
+void graph_page_push(uint32_t time, float temp, float precip){
+    uint32_t hour = time / 3600;
+    if(last_hour != 0 && hour < last_hour){ //older than what is shown
+        return;
+    }
+    if(last_hour != 0 && hour != last_hour){ //advance, blanking skipped hours
+        uint32_t steps = hour - last_hour;
+        if(steps > GRAPH_COLUMNS){
+            steps = GRAPH_COLUMNS;
+        }
+        for(uint32_t i = 0; i < steps; ++i){
+            cursor = (cursor + 1) % GRAPH_COLUMNS;
+            samples[cursor].valid = false;
+            draw_column(cursor);
+        }
+    }
+    last_hour = hour;
+
+    samples[cursor] = (GraphSample){ .temp = temp, .precip = precip, .valid = true };
+
+    //blank gap after the newest column marks where the sweep is, its reading leaves the scale too
+    uint8_t gap = (cursor + 1) % GRAPH_COLUMNS;
+    samples[gap].valid = false;
+    if(fit_scale()){ //rare, the scale changed so every column moves
+        for(int i = 0; i < GRAPH_COLUMNS; ++i){
+            draw_column(i);
+        }
+    }
+    else{
+        draw_column(cursor);
+        draw_column(gap);
+    }
+}
+
+void graph_page_push_now(float temp, float precip){
+    graph_page_push(time(NULL), temp, precip);
+}
@@ -0,0 +1,21 @@
+#ifndef graph_page
+#define graph_page
+
+//No time.h here, i2c_oled.c has a label called time
+#include "lvgl.h"
+#include "stdint.h"
+
+//Plot geometry on the 128x64 panel
+#define GRAPH_COLUMNS 24     //one column per hour
+#define GRAPH_COL_W 4
+#define GRAPH_TEMP_H 44      //rows used by the temperature trace
+#define GRAPH_PRECIP_H 16    //rows used by the precipitation bars at the bottom
+#define GRAPH_PRECIP_FULL 0.5f //inches per hour that fill a bar
+#define GRAPH_TEMP_STEP 10   //axis bounds snap to this many degrees
+
+void graph_page_create(lv_obj_t *parent);
+void graph_page_seed();
+void graph_page_push(uint32_t time, float temp, float precip);
+void graph_page_push_now(float temp, float precip);
+
+#endif // graph_page
@@ -0,0 +1,413 @@
+/*
+This file inflates gzip bodies as they arrive, one chunk at a time
+The decoder is a state machine that only consumes bits once a whole unit
+(header byte, code, extra bits) is there, so a chunk may end anywhere.
+Huffman decoding is the canonical count/symbol walk from zlib's puff.
+*/
+
+#include "gzip_stream.h"
+#include "string.h"
+#include "esp_rom_crc.h"
+
+#define FHCRC 0x02
+#define FEXTRA 0x04
+#define FNAME 0x08
+#define FCOMMENT 0x10
+#define MAX_CODE_BITS 15
+
+enum {
+    S_HEADER, S_EXTRA_LEN, S_EXTRA, S_NAME, S_COMMENT, S_HCRC,
+    S_BLOCK, S_STORED_LEN, S_STORED,
+    S_TABLE_COUNTS, S_TABLE_CODES, S_TABLE_LENGTHS, S_TABLE_REPEAT,
+    S_SYMBOL, S_LENGTH_EXTRA, S_DISTANCE, S_DISTANCE_EXTRA,
+    S_TRAILER, S_END
+};
+
+//Static variables
+static const uint16_t length_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t length_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static const uint8_t code_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+void gzip_init(GzipStream* gz, GzipSink sink, void* arg){
+    memset(gz, 0, sizeof(*gz));
+    gz->sink = sink;
+    gz->arg = arg;
+    gz->state = S_HEADER;
+    gz->status = GZIP_MORE;
+}
+
+//Pulls input bytes into the bit buffer until n bits are there, false if the chunk ran out first
+static bool need(GzipStream* gz, int n){
+    while(gz->nbits < n){
+        if(gz->in_left == 0){
+            return false;
+        }
+        gz->bits |= (uint32_t)*gz->in++ << gz->nbits;
+        gz->nbits += 8;
+        gz->in_left--;
+    }
+    return true;
+}
+
+static uint32_t take(GzipStream* gz, int n){
+    uint32_t value = gz->bits & ((1u << n) - 1);
+    gz->bits >>= n;
+    gz->nbits -= n;
+    return value;
+}
+
+static void flush(GzipStream* gz){
+    if(gz->pos > gz->flushed){
+        gz->crc = esp_rom_crc32_le(gz->crc, gz->window + gz->flushed, gz->pos - gz->flushed);
+        gz->sink(gz->arg, (const char*)gz->window + gz->flushed, gz->pos - gz->flushed);
+        gz->flushed = gz->pos;
+    }
+}
+
+static void put(GzipStream* gz, uint8_t byte){
+    gz->window[gz->pos++] = byte;
+    gz->total++;
+    if(gz->pos == GZIP_WINDOW){
+        flush(gz);
+        gz->pos = 0;
+        gz->flushed = 0;
+    }
+}
+
+static int fail(GzipStream* gz, GzipStatus status){
+    gz->status = status;
+    return 0;
+}
+
+//Builds the count/symbol tables from code lengths, -1 if the lengths oversubscribe the code space
+static int build(uint16_t* count, uint16_t* symbol, const uint8_t* length, int n){
+    uint16_t offset[MAX_CODE_BITS + 1];
+    memset(count, 0, sizeof(uint16_t) * (MAX_CODE_BITS + 1));
+    for(int i = 0; i < n; ++i){
+        count[length[i]]++;
+    }
+    int left = 1;
+    for(int len = 1; len <= MAX_CODE_BITS; ++len){
+        left = (left << 1) - count[len];
+        if(left < 0){
+            return -1;
+        }
+    }
+    offset[1] = 0;
+    for(int len = 1; len < MAX_CODE_BITS; ++len){
+        offset[len + 1] = offset[len] + count[len];
+    }
+    for(int i = 0; i < n; ++i){
+        if(length[i] != 0){
+            symbol[offset[length[i]]++] = i;
+        }
+    }
+    return left;
+}
+
+//Returns the next symbol, -1 when the chunk ran out, -2 for a code missing from the table
+//Waiting for MAX_CODE_BITS is safe, every code is followed by at least the 8 byte trailer
+static int decode(GzipStream* gz, const uint16_t* count, const uint16_t* symbol){
+    if(!need(gz, MAX_CODE_BITS)){
+        return -1;
+    }
+    int code = 0, first = 0, index = 0;
+    uint32_t bits = gz->bits;
+    for(int len = 1; len <= MAX_CODE_BITS; ++len){
+        code |= bits & 1;
+        bits >>= 1;
+        if(code - count[len] < first){
+            take(gz, len);
+            return symbol[index + (code - first)];
+        }
+        index += count[len];
+        first = (first + count[len]) << 1;
+        code <<= 1;
+    }
+    return -2;
+}
+
+static void fixed_tables(GzipStream* gz){
+    int i = 0;
+    for(; i < 144; ++i) gz->lengths[i] = 8;
+    for(; i < 256; ++i) gz->lengths[i] = 9;
+    for(; i < 280; ++i) gz->lengths[i] = 7;
+    for(; i < 288; ++i) gz->lengths[i] = 8;
+    build(gz->lencnt, gz->lensym, gz->lengths, 288);
+    for(i = 0; i < 30; ++i) gz->lengths[i] = 5;
+    build(gz->distcnt, gz->distsym, gz->lengths, 30);
+}
+
+static void end_block(GzipStream* gz){
+    gz->state = gz->last_block ? S_TRAILER : S_BLOCK;
+    gz->count = 0;
+}
+
+//Runs one unit of the state machine, 0 once it needs more input or stopped
+static int step(GzipStream* gz){
+    int sym;
+    switch(gz->state){
+    case S_HEADER: //ID1 ID2 CM FLG MTIME(4) XFL OS
+        if(!need(gz, 8)){
+            return 0;
+        }
+        sym = take(gz, 8);
+        if((gz->count == 0 && sym != 0x1f) || (gz->count == 1 && sym != 0x8b) || (gz->count == 2 && sym != 8)){
+            return fail(gz, GZIP_ERROR);
+        }
+        if(gz->count == 3){
+            gz->flags = sym;
+        }
+        if(++gz->count == 10){
+            gz->count = 0;
+            gz->state = S_EXTRA_LEN;
+        }
+        return 1;
+    case S_EXTRA_LEN:
+        if(gz->flags & FEXTRA){
+            if(!need(gz, 16)){
+                return 0;
+            }
+            gz->count = take(gz, 16);
+        }
+        gz->state = S_EXTRA;
+        return 1;
+    case S_EXTRA:
+        if(gz->count > 0){
+            if(!need(gz, 8)){
+                return 0;
+            }
+            take(gz, 8);
+            gz->count--;
+            return 1;
+        }
+        gz->state = S_NAME;
+        return 1;
+    case S_NAME:
+    case S_COMMENT: //zero terminated, skipped
+        if(gz->flags & (gz->state == S_NAME ? FNAME : FCOMMENT)){
+            if(!need(gz, 8)){
+                return 0;
+            }
+            if(take(gz, 8) != 0){
+                return 1;
+            }
+        }
+        gz->state++;
+        return 1;
+    case S_HCRC:
+        if(gz->flags & FHCRC){
+            if(!need(gz, 16)){
+                return 0;
+            }
+            take(gz, 16);
+        }
+        gz->state = S_BLOCK;
+        return 1;
+
+    case S_BLOCK:
+        if(!need(gz, 3)){
+            return 0;
+        }
+        gz->last_block = take(gz, 1);
+        switch(take(gz, 2)){
+        case 0:
+            take(gz, gz->nbits & 7); //stored blocks start on a byte
+            gz->state = S_STORED_LEN;
+            return 1;
+        case 1:
+            fixed_tables(gz);
+            gz->state = S_SYMBOL;
+            return 1;
+        case 2:
+            gz->state = S_TABLE_COUNTS;
+            return 1;
+        default:
+            return fail(gz, GZIP_ERROR);
+        }
+    case S_STORED_LEN: //LEN and NLEN, the bit buffer is byte aligned and at most 16 bits full here
+        if(!need(gz, 32)){
+            return 0;
+        }
+        if((gz->bits & 0xffff) != (~gz->bits >> 16)){
+            return fail(gz, GZIP_ERROR);
+        }
+        gz->count = gz->bits & 0xffff;
+        gz->bits = 0;
+        gz->nbits = 0;
+        gz->state = S_STORED;
+        return 1;
+    case S_STORED:
+        if(gz->count == 0){
+            end_block(gz);
+            return 1;
+        }
+        if(gz->in_left == 0){
+            return 0;
+        }
+        sym = gz->in_left < gz->count ? gz->in_left : gz->count;
+        for(int i = 0; i < sym; ++i){
+            put(gz, gz->in[i]);
+        }
+        gz->in += sym;
+        gz->in_left -= sym;
+        gz->count -= sym;
+        return 1;
+
+    case S_TABLE_COUNTS:
+        if(!need(gz, 14)){
+            return 0;
+        }
+        gz->nlen = take(gz, 5) + 257;
+        gz->ndist = take(gz, 5) + 1;
+        gz->ncode = take(gz, 4) + 4;
+        if(gz->nlen > 286 || gz->ndist > 30){
+            return fail(gz, GZIP_ERROR);
+        }
+        memset(gz->lengths, 0, 19);
+        gz->filled = 0;
+        gz->state = S_TABLE_CODES;
+        return 1;
+    case S_TABLE_CODES: //lengths of the code that packs the real code lengths
+        if(gz->filled < gz->ncode){
+            if(!need(gz, 3)){
+                return 0;
+            }
+            gz->lengths[code_order[gz->filled++]] = take(gz, 3);
+            return 1;
+        }
+        if(build(gz->lencnt, gz->lensym, gz->lengths, 19) < 0){
+            return fail(gz, GZIP_ERROR);
+        }
+        gz->filled = 0;
+        gz->state = S_TABLE_LENGTHS;
+        return 1;
+    case S_TABLE_LENGTHS:
+        if(gz->filled == gz->nlen + gz->ndist){
+            if(gz->lengths[256] == 0 ||
+               build(gz->lencnt, gz->lensym, gz->lengths, gz->nlen) < 0 ||
+               build(gz->distcnt, gz->distsym, gz->lengths + gz->nlen, gz->ndist) < 0){
+                return fail(gz, GZIP_ERROR);
+            }
+            gz->state = S_SYMBOL;
+            return 1;
+        }
+        sym = decode(gz, gz->lencnt, gz->lensym);
+        if(sym == -1){
+            return 0;
+        }
+        if(sym < 0 || (sym == 16 && gz->filled == 0)){
+            return fail(gz, GZIP_ERROR);
+        }
+        if(sym < 16){
+            gz->lengths[gz->filled++] = sym;
+            return 1;
+        }
+        gz->symbol = sym;
+        gz->state = S_TABLE_REPEAT;
+        return 1;
+    case S_TABLE_REPEAT: { //16 repeats the last length 3-6 times, 17 and 18 are runs of zeros
+        int extra = gz->symbol == 16 ? 2 : gz->symbol == 17 ? 3 : 7;
+        if(!need(gz, extra)){
+            return 0;
+        }
+        int repeat = take(gz, extra) + (gz->symbol == 18 ? 11 : 3);
+        uint8_t value = gz->symbol == 16 ? gz->lengths[gz->filled - 1] : 0;
+        if(gz->filled + repeat > gz->nlen + gz->ndist){
+            return fail(gz, GZIP_ERROR);
+        }
+        while(repeat-- > 0){
+            gz->lengths[gz->filled++] = value;
+        }
+        gz->state = S_TABLE_LENGTHS;
+        return 1;
+    }
+
+    case S_SYMBOL:
+        sym = decode(gz, gz->lencnt, gz->lensym);
+        if(sym == -1){
+            return 0;
+        }
+        if(sym < 0 || sym > 285){
+            return fail(gz, GZIP_ERROR);
+        }
+        if(sym < 256){
+            put(gz, sym);
+        }
+        else if(sym == 256){
+            end_block(gz);
+        }
+        else{
+            gz->symbol = sym - 257;
+            gz->state = S_LENGTH_EXTRA;
+        }
+        return 1;
+    case S_LENGTH_EXTRA:
+        if(!need(gz, length_extra[gz->symbol])){
+            return 0;
+        }
+        gz->match_len = length_base[gz->symbol] + take(gz, length_extra[gz->symbol]);
+        gz->state = S_DISTANCE;
+        return 1;
+    case S_DISTANCE:
+        sym = decode(gz, gz->distcnt, gz->distsym);
+        if(sym == -1){
+            return 0;
+        }
+        if(sym < 0 || sym >= 30){
+            return fail(gz, GZIP_ERROR);
+        }
+        gz->symbol = sym;
+        gz->state = S_DISTANCE_EXTRA;
+        return 1;
+    case S_DISTANCE_EXTRA: {
+        if(!need(gz, dist_extra[gz->symbol])){
+            return 0;
+        }
+        uint32_t dist = dist_base[gz->symbol] + take(gz, dist_extra[gz->symbol]);
+        if(dist > gz->total){
+            return fail(gz, GZIP_ERROR);
+        }
+        if(dist > GZIP_WINDOW){
+            return fail(gz, GZIP_FAR);
+        }
+        for(int i = 0; i < gz->match_len; ++i){ //byte by byte, the copy may overlap what it writes
+            put(gz, gz->window[(gz->pos - dist) & (GZIP_WINDOW - 1)]);
+        }
+        gz->state = S_SYMBOL;
+        return 1;
+    }
+
+    case S_TRAILER: //CRC32 and ISIZE, little endian
+        take(gz, gz->nbits & 7);
+        if(!need(gz, 8)){
+            return 0;
+        }
+        gz->trailer[gz->count / 4] |= take(gz, 8) << (8 * (gz->count % 4));
+        if(++gz->count < 8){
+            return 1;
+        }
+        flush(gz);
+        gz->state = S_END;
+        gz->status = gz->trailer[0] == gz->crc && gz->trailer[1] == gz->total ? GZIP_DONE : GZIP_ERROR;
+        return 0;
+    default:
+        return 0;
+    }
+}
+
+//Inflates a chunk, returns GZIP_MORE until the trailer checked out or the stream failed
+GzipStatus gzip_push(GzipStream* gz, const uint8_t* data, int len){
+    gz->in = data;
+    gz->in_left = len;
+    while(gz->status == GZIP_MORE && step(gz)){
+    }
+    flush(gz);
+    return gz->status;
+}
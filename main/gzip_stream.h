@@ -0,0 +1,61 @@
+#ifndef gzip_stream
+#define gzip_stream
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//Push inflater for gzip bodies, input can be cut anywhere and output leaves through the sink
+//Only the last GZIP_WINDOW bytes are kept for back references, a body that reaches further
+//back fails with GZIP_FAR. A reference cannot go past the start of the body, so anything up to
+//GZIP_WINDOW bytes of JSON always inflates: the current/daily answer is about 200 bytes.
+//Bigger answers (hourly data) can fail, weather_api.c then asks again for plain JSON.
+#define GZIP_WINDOW_BITS 12
+#define GZIP_WINDOW (1 << GZIP_WINDOW_BITS)
+
+typedef void (*GzipSink)(void* arg, const char* data, int len);
+
+typedef enum {
+    GZIP_MORE,  //waiting for input
+    GZIP_DONE,  //trailer checked, everything went to the sink
+    GZIP_ERROR, //not gzip, corrupt, or crc/length mismatch
+    GZIP_FAR,   //a back reference beyond GZIP_WINDOW
+} GzipStatus;
+
+typedef struct {
+    GzipSink sink;
+    void* arg;
+    uint8_t state;
+    GzipStatus status;
+    const uint8_t* in;   //chunk being pushed
+    int in_left;
+    uint32_t bits;       //bit buffer, LSB first as deflate packs them
+    uint8_t nbits;
+    bool last_block;
+
+    //gzip header, stored blocks and trailer
+    uint8_t flags;
+    uint16_t count;
+    uint32_t trailer[2];
+
+    //Huffman tables as counts per length and symbols in code order
+    uint16_t lencnt[16];
+    uint16_t lensym[288];
+    uint16_t distcnt[16];
+    uint16_t distsym[32];
+    uint8_t lengths[288 + 32]; //code lengths of a dynamic block header
+    uint16_t nlen, ndist, ncode, filled;
+    uint16_t symbol;     //decoded, waiting for its extra bits
+    uint16_t match_len;
+
+    //History, flushed to the sink when it wraps and at the end of every push
+    uint8_t window[GZIP_WINDOW];
+    uint16_t pos;
+    uint16_t flushed;
+    uint32_t total;      //bytes inflated
+    uint32_t crc;
+} GzipStream;
+
+void gzip_init(GzipStream* gz, GzipSink sink, void* arg);
+GzipStatus gzip_push(GzipStream* gz, const uint8_t* data, int len);
+
+#endif // gzip_stream
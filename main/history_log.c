@@ -0,0 +1,255 @@
+/*
+This file keeps every weather reading in a ring of flash sectors
+Each sector starts with a header holding the full time and temperature, records after it
+only store deltas so one reading takes 4 bytes. Sectors are erased once per trip around
+the ring. Each record is written as soon as it arrives so a reset loses nothing, batching
+would not save erases since those only depend on how many records fit a sector.
+Lookups by time only read the sector headers (cached in RAM) and decode the sectors in range.
+*/
+
+#include "history_log.h"
+#include "metrics.h"
+#include "string.h"
+#include "math.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+
+#define SECTOR_SIZE 4096
+#define MAX_SECTORS 16
+#define HISTORY_MAGIC 0x57484C31 //"WHL1"
+#define DT_UNIT_S (5 * 60)       //record time resolution
+#define DT_MAX 254               //0xFF marks an erased record
+#define READ_CHUNK 64            //records read from flash at once
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;       //grows by one per opened sector, the highest is the one being written
+    uint32_t base_time; //time of the first record
+    int16_t base_temp;  //temperature of the first record in 0.5 F
+    uint16_t reserved;
+} SectorHeader;
+
+typedef struct {
+    uint8_t dt;         //time since the previous record in DT_UNIT_S
+    int8_t dtemp;       //temperature change since the previous record in 0.5 F
+    uint8_t precip;     //precipitation in 0.01 inch
+    uint8_t code;       //Open Meteo weather code
+} Record;
+
+#define RECORDS_PER_SECTOR ((SECTOR_SIZE - sizeof(SectorHeader)) / sizeof(Record))
+
+//Static variables
+static const esp_partition_t *part = NULL;
+static uint8_t sector_count = 0;
+static uint32_t sector_seq[MAX_SECTORS];  //0 for sectors never written
+static uint32_t sector_base[MAX_SECTORS];
+static uint32_t max_seq = 0;
+static uint8_t cur = 0;                   //sector being written
+static uint16_t cur_records = 0;          //records of cur already in flash
+static uint32_t last_time = 0;
+static int16_t last_temp = 0;
+
+static size_t record_addr(uint8_t sector, uint16_t index){
+    return sector * SECTOR_SIZE + sizeof(SectorHeader) + index * sizeof(Record);
+}
+
+//Decodes the records of one sector in order, cb may be NULL to only rebuild the running values
+//Returns the number of readings passed to cb
+static int replay(uint8_t sector, uint16_t count, time_t from, time_t to, HistoryCb cb, void* arg){
+    Record chunk[READ_CHUNK];
+    HistoryReading reading;
+    uint32_t t = sector_base[sector];
+    int16_t temp;
+    int matched = 0;
+    SectorHeader header;
+
+    esp_partition_read(part, sector * SECTOR_SIZE, &header, sizeof(header));
+    temp = header.base_temp;
+
+    for(uint16_t i = 0; i < count; i += READ_CHUNK){
+        uint16_t n = count - i < READ_CHUNK ? count - i : READ_CHUNK;
+        esp_partition_read(part, record_addr(sector, i), chunk, n * sizeof(Record));
+        for(uint16_t j = 0; j < n; ++j){
+            if(chunk[j].dt == 0xFF){ //sector was closed early, the rest is erased
+                count = 0;
+                break;
+            }
+            t += chunk[j].dt * DT_UNIT_S;
+            temp += chunk[j].dtemp;
+            if(cb != NULL && t >= from && t <= to){
+                reading.time = t;
+                reading.temp = temp / 2.0f;
+                reading.precip = chunk[j].precip / 100.0f;
+                reading.code = chunk[j].code;
+                cb(&reading, arg);
+                matched++;
+            }
+        }
+    }
+    if(cb == NULL){
+        last_time = t;
+        last_temp = temp;
+    }
+    return matched;
+}
+
+//Finds the newest sector and where its records end, only headers and a binary search are read
+esp_err_t history_log_init(){
+    SectorHeader header;
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, HISTORY_SUBTYPE, HISTORY_PARTITION);
+    if(part == NULL){
+        ESP_LOGW("HISTORY", "No %s partition", HISTORY_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+    sector_count = part->size / SECTOR_SIZE;
+    if(sector_count > MAX_SECTORS){
+        sector_count = MAX_SECTORS;
+    }
+
+    for(uint8_t s = 0; s < sector_count; ++s){
+        esp_partition_read(part, s * SECTOR_SIZE, &header, sizeof(header));
+        sector_seq[s] = header.magic == HISTORY_MAGIC ? header.seq : 0;
+        sector_base[s] = header.base_time;
+        if(sector_seq[s] > max_seq){
+            max_seq = sector_seq[s];
+            cur = s;
+        }
+    }
+    if(max_seq == 0){ //empty log
+        ESP_LOGI("HISTORY", "Empty log, %d sectors of %d records", sector_count, RECORDS_PER_SECTOR);
+        return ESP_OK;
+    }
+
+    //records are written front to back, find the first erased one
+    uint16_t lo = 0, hi = RECORDS_PER_SECTOR;
+    Record rec;
+    while(lo < hi){
+        uint16_t mid = (lo + hi) / 2;
+        esp_partition_read(part, record_addr(cur, mid), &rec, sizeof(rec));
+        if(rec.dt == 0xFF){
+            hi = mid;
+        }
+        else{
+            lo = mid + 1;
+        }
+    }
+    cur_records = lo;
+    replay(cur, cur_records, 0, 0, NULL, NULL);
+    ESP_LOGI("HISTORY", "Sector %d (seq %lu) has %d records", cur, max_seq, cur_records);
+    return ESP_OK;
+}
+
+//Erases the next sector of the ring and starts it with a full time and temperature
+static esp_err_t open_sector(uint32_t time, int16_t temp){
+    uint8_t next = max_seq == 0 ? 0 : (cur + 1) % sector_count;
+    esp_err_t err = esp_partition_erase_range(part, next * SECTOR_SIZE, SECTOR_SIZE);
+    if(err != ESP_OK){
+        return err;
+    }
+    SectorHeader header = {
+        .magic = HISTORY_MAGIC,
+        .seq = max_seq + 1,
+        .base_time = time,
+        .base_temp = temp,
+        .reserved = 0xFFFF,
+    };
+    err = esp_partition_write(part, next * SECTOR_SIZE, &header, sizeof(header));
+    if(err != ESP_OK){
+        return err;
+    }
+    max_seq = header.seq;
+    sector_seq[next] = header.seq;
+    sector_base[next] = time;
+    cur = next;
+    cur_records = 0;
+    last_time = time;
+    last_temp = temp;
+    app_metrics.history_erases++;
+    return ESP_OK;
+}
+
+//Adds one reading, api_values is {LENGTH, TEMPERATURE, PRECIPITATION, WEATHER CODE}
+esp_err_t history_log_append(time_t time, const float* api_values){
+    if(part == NULL){
+        return ESP_ERR_INVALID_STATE;
+    }
+    int32_t temp = lroundf(api_values[1] * 2);
+    int32_t precip = lroundf(api_values[2] * 100);
+    uint32_t dt = 0;
+    bool new_sector = max_seq == 0 || cur_records >= RECORDS_PER_SECTOR;
+
+    if(!new_sector){
+        if((uint32_t)time > last_time){ //a clock step backwards keeps dt at 0
+            dt = ((uint32_t)time - last_time + DT_UNIT_S / 2) / DT_UNIT_S;
+        }
+        int32_t dtemp = temp - last_temp;
+        new_sector = dt > DT_MAX || dtemp > INT8_MAX || dtemp < INT8_MIN;
+    }
+    if(new_sector){
+        esp_err_t err = open_sector((uint32_t)time, temp);
+        if(err != ESP_OK){
+            ESP_LOGW("HISTORY", "Could not open sector: %s", esp_err_to_name(err));
+            return err;
+        }
+        dt = 0;
+    }
+
+    Record rec = {
+        .dt = dt,
+        .dtemp = temp - last_temp,
+        .precip = precip < 0 ? 0 : (precip > UINT8_MAX ? UINT8_MAX : precip),
+        .code = (uint8_t)api_values[3],
+    };
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err = esp_partition_write(part, record_addr(cur, cur_records), &rec, sizeof(rec));
+    app_metrics.history_write_us = esp_timer_get_time() - start_us;
+    if(err != ESP_OK){
+        ESP_LOGW("HISTORY", "Could not write record: %s", esp_err_to_name(err));
+        return err;
+    }
+    cur_records++;
+    last_time += dt * DT_UNIT_S;
+    last_temp = temp;
+    app_metrics.history_records++;
+    return ESP_OK;
+}
+
+//Calls cb for every reading between from and to (inclusive), oldest first
+//Sectors whose time span is outside the range are skipped without being read
+int history_log_query(time_t from, time_t to, HistoryCb cb, void* arg){
+    uint8_t order[MAX_SECTORS];
+    uint8_t used = 0;
+    int matched = 0;
+    if(part == NULL){
+        return 0;
+    }
+    int64_t start_us = esp_timer_get_time();
+
+    for(uint8_t s = 0; s < sector_count; ++s){ //sort written sectors by sequence
+        if(sector_seq[s] == 0){
+            continue;
+        }
+        uint8_t i = used++;
+        while(i > 0 && sector_seq[order[i - 1]] > sector_seq[s]){
+            order[i] = order[i - 1];
+            --i;
+        }
+        order[i] = s;
+    }
+
+    app_metrics.history_query_sectors = 0;
+    for(uint8_t i = 0; i < used; ++i){
+        uint8_t s = order[i];
+        time_t start = sector_base[s];
+        time_t end = i + 1 < used ? (time_t)sector_base[order[i + 1]] : to + 1;
+        if(end <= from || start > to){
+            continue;
+        }
+        uint16_t count = s == cur ? cur_records : RECORDS_PER_SECTOR;
+        matched += replay(s, count, from, to, cb, arg);
+        app_metrics.history_query_sectors++;
+    }
+    app_metrics.history_query_us = esp_timer_get_time() - start_us;
+    return matched;
+}
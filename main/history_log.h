@@ -0,0 +1,26 @@
+#ifndef history_log
+#define history_log
+
+#include "stdint.h"
+#include "time.h"
+#include "esp_err.h"
+
+//Partition holding the log, see partitions.csv
+#define HISTORY_PARTITION "history"
+#define HISTORY_SUBTYPE 0x40
+
+//One decoded reading
+typedef struct {
+    time_t time;
+    float temp;
+    float precip;
+    uint8_t code;
+} HistoryReading;
+
+typedef void (*HistoryCb)(const HistoryReading* reading, void* arg);
+
+esp_err_t history_log_init();
+esp_err_t history_log_append(time_t time, const float* api_values);
+int history_log_query(time_t from, time_t to, HistoryCb cb, void* arg);
+
+#endif // history_log
@@ -9,6 +9,7 @@ This file is used to setup and run the i2c OLED display
 */
 
 #include <stdio.h>
+#include <string.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_lcd_panel_io.h"
@@ -19,9 +20,20 @@ This file is used to setup and run the i2c OLED display
 #include "esp_lvgl_port.h"
 #include "lvgl.h"
 #include "esp_mac.h"
+#include "esp_timer.h"
 #include "esp_lcd_panel_vendor.h"
-#include "fonts/fonts.h"
+#include "asset_store.h"
 #include "esp_log.h"
+#include "task_plan.h"
+#include "graph_page.h"
+#include "page_cache.h"
+#include "panel_bus.h"
+#include "info_pages.h"
+#include "digit_clock.h"
+#include "metrics.h"
+#include "blog.h"
+#include "trace.h"
+#include "i2c_oled.h"
 
 //Pins
 #define PIN_NUM_SDA           GPIO_NUM_21
@@ -29,10 +41,10 @@ This file is used to setup and run the i2c OLED display
 #define I2C_HW_ADDR           0x3C
 
 //Display dimensions
-#define LCD_H_RES             128
-#define LCD_V_RES             64
+#define LCD_H_RES             PAGE_H_RES
+#define LCD_V_RES             PAGE_V_RES
 
-#define LCD_PIXEL_CLOCK_HZ    (400 * 1000)
+#define LCD_PIXEL_CLOCK_HZ    PANEL_SCL_HZ
 #define LCD_CMD_BITS           8
 #define LCD_PARAM_BITS         8
 
@@ -52,6 +64,7 @@ This file is used to setup and run the i2c OLED display
 static esp_lcd_panel_handle_t panel_handle = NULL;
 static lv_obj_t *scr = NULL;
 static char buf[buf_len];
+static bool clock_atlas = false; //time label replaced by digit_clock
 
 //LVGL Labels
 static lv_obj_t *time = NULL;
@@ -62,12 +75,6 @@ static lv_obj_t *precip_img = NULL;
 static lv_obj_t *weather = NULL;
 static lv_obj_t *wea_label = NULL;
 
-//Stores the name of a weather type and its macro font label
-typedef struct { 
-    const char* font_label;
-    const char* name;
-} WeatherLabel;
-
 const WeatherLabel WeatherData[] = {
     {clear_sky,"Clear Sky"},
     {cloudy, "Cloudy"},
@@ -102,8 +109,10 @@ void oled_init(void)
         .lcd_cmd_bits = LCD_CMD_BITS,   // According to SSD1306 datasheet
         .lcd_param_bits = LCD_CMD_BITS, // According to SSD1306 datasheet
         .dc_bit_offset = 6,             // According to SSD1306 datasheet
+        .on_color_trans_done = panel_bus_flush_done,
     };
     ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c(i2c_bus, &io_config, &io_handle));
+    panel_bus_attach(io_handle); //before the driver, so the init commands are counted
 
     ESP_LOGI(TAG, "Install SSD1306 panel driver");
     esp_lcd_panel_dev_config_t panel_config = {
@@ -124,28 +133,44 @@ void oled_init(void)
     TAG = "LVGL";
     lv_init();
 
-    const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
-    lvgl_port_init(&lvgl_cfg);
-    const lvgl_port_display_cfg_t disp_cfg = {
-        .io_handle = io_handle,
-        .panel_handle = panel_handle,
-        .buffer_size = LCD_H_RES * LCD_V_RES,
-        .double_buffer = true,
-        .hres = LCD_H_RES,
-        .vres = LCD_V_RES,
-        .monochrome = true,
-        .rotation = {
-            .swap_xy = false,
-            .mirror_x = false,
-            .mirror_y = false,
-        }
-    };
-    lv_disp_t*disp = lvgl_port_add_disp(&disp_cfg);
+    lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_cfg.task_affinity = LVGL_PORT_CORE;
+    lvgl_cfg.task_priority = LVGL_PORT_PRIORITY;
+    lvgl_port_init(&lvgl_cfg); //LVGL task, tick and lock, the displays come from page_cache
+
+    // Rotation of the screen, done by the panel so the page framebuffers can be blitted as is
+    ESP_ERROR_CHECK(esp_lcd_panel_mirror(panel_handle, true, true));
+
+    if (lvgl_port_lock(0)) {
+        page_cache_init(panel_handle);
+        scr = page_cache_screen(PAGE_NOW);
+        lvgl_port_unlock();
+    }
     ESP_LOGI(TAG, "Finished LVGL initialization");
+}
 
-    // Rotation of the screen
-    lv_disp_set_rotation(disp, LV_DISP_ROT_180);
-    scr = lv_disp_get_scr_act(disp);
+//Returns the symbol and name for an Open Meteo weather code, NULL if the code is unknown
+const WeatherLabel* weather_label(float code){
+    if(code == 0){ //if weather code fits ranges from OpenMeteo
+        return &WeatherData[0];
+    }
+    else if(code > 0 && code <=48){
+        return &WeatherData[1];
+    }
+    else if(code > 48 && code <=57){
+        return &WeatherData[2];
+    }
+    else if( (code >=61 && code <=67) || (code >= 80 && code <= 82) ){
+        return &WeatherData[3];
+    }
+    else if( (code >=71 && code <=77) || (code >= 85 && code <= 86) ){
+        return &WeatherData[5]; //snow
+    }
+    else if(code >= 95){
+        return &WeatherData[4]; //thunder
+    }
+    ESP_LOGE("ERROR","CANT FIND WEATHER CODE");
+    return NULL;
 }
 
 void lvgl_init(void){ //creates all the labels for lvgl elements
@@ -165,114 +190,197 @@ void lvgl_init(void){ //creates all the labels for lvgl elements
         //Time
         lv_label_set_text(time, "X:XX");
         lv_obj_align(time, LV_ALIGN_TOP_LEFT, 0, 0);
-        lv_obj_set_style_text_font(time, &jetbrains_mono_16,0);
+        lv_obj_set_style_text_font(time, asset_font(ASSET_FONT_TEXT),0);
 
         //Date
         lv_label_set_text(date, "XX/XX/XX");
         lv_obj_align(date, LV_ALIGN_TOP_LEFT, 0, 20);
-        lv_obj_set_style_text_font(date, &jetbrains_mono_16,0);
+        lv_obj_set_style_text_font(date, asset_font(ASSET_FONT_TEXT),0);
 
         //Weather
         lv_label_set_text(weather, clear_sky);
         lv_obj_align(weather, LV_ALIGN_TOP_LEFT, 0, 40);
-        lv_obj_set_style_text_font(weather, &weather_symbols,0);
+        lv_obj_set_style_text_font(weather, asset_font(ASSET_FONT_SYMBOLS),0);
 
         //Weather Label
         lv_label_set_text(wea_label, "LOADING");
         lv_obj_align(wea_label, LV_ALIGN_TOP_LEFT, 20, 40);
-        lv_obj_set_style_text_font(wea_label, &jetbrains_mono_16,0);
+        lv_obj_set_style_text_font(wea_label, asset_font(ASSET_FONT_TEXT),0);
 
         //Temperature
         lv_label_set_text(temp, "XX°F");
         lv_obj_align(temp, LV_ALIGN_TOP_RIGHT, 0, 0);
-        lv_obj_set_style_text_font(temp, &jetbrains_mono_16,0);
+        lv_obj_set_style_text_font(temp, asset_font(ASSET_FONT_TEXT),0);
 
         //Precipitation Amount
         lv_label_set_text(precip,"X.XX");
         lv_obj_align(precip, LV_ALIGN_TOP_RIGHT, 0, 20);
-        lv_obj_set_style_text_font(precip, &jetbrains_mono_16,0);
+        lv_obj_set_style_text_font(precip, asset_font(ASSET_FONT_TEXT),0);
 
         //Precipitation Image
         lv_label_set_text(precip_img, precipipation);
         lv_obj_align_to(precip_img, precip,LV_ALIGN_TOP_RIGHT, -40, 0);
-        lv_obj_set_style_text_font(precip_img, &weather_symbols,0);
+        lv_obj_set_style_text_font(precip_img, asset_font(ASSET_FONT_SYMBOLS),0);
+
+        //Other pages, rendered in the background into their own framebuffers
+        forecast_page_create(page_cache_screen(PAGE_FORECAST));
+        graph_page_create(page_cache_screen(PAGE_HISTORY));
+        stats_page_create(page_cache_screen(PAGE_STATS));
+
+#if DIGIT_CLOCK
+        //Clock fast path, the label stays around hidden in case the font does not fit the atlas
+        clock_atlas = digit_clock_init(asset_font(ASSET_FONT_TEXT));
+        if(clock_atlas){
+            lv_obj_add_flag(time, LV_OBJ_FLAG_HIDDEN);
+        }
+#endif
 
         // Release the mutex    
         lvgl_port_unlock();
     }
 }
 
+//Formats the clock label, data is {LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES, SECONDS}
+void format_time_label(const float* data, char* out, size_t len){
+#if CLOCK_SECONDS
+    snprintf(out, len, "%02d:%02d:%02d", (int)data[4], (int)data[5], (int)data[6]);
+    return;
+#endif
+    uint8_t hour = (((int)data[4] + 11) % 12) + 1; //conversion to 12-hour time
+    snprintf(out, len, "%02d:%02d", hour, (int)data[5]);
+    if((int)data[4] < 12){ //add am / pm
+        strlcat(out,"AM",len);
+    }
+    else{
+        strlcat(out,"PM",len);
+    }
+}
+
+//Formats the date label from the same data
+void format_date_label(const float* data, char* out, size_t len){
+    uint8_t year = (int)data[3]-2000;
+    snprintf(out, len, "%02d/%02d/%d", (int)data[2], (int)data[1],year);
+}
+
 //Updates the lvgl labels depending on the type of data
 void lvgl_update(float* data){
     if (lvgl_port_lock(0)) {
+        TRACE_MARK(TRACE_LOCK, (int)data[0]);
+        TRACE_BEGIN(TRACE_LABEL_SET, (int)data[0]);
         uint8_t data_len = (int)data[0];
-        ESP_LOGI("LVGL","Data Length:%d",data_len);
+        BLOG(BLOG_LVGL_DATA_LEN, data_len);
         
         //Time and Date
-        if(data_len == 6){ //{LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES}
-            ESP_LOGI("LVGL","Updating the Time and Date");
+        if(data_len == TIME_ITEM_SIZE){ //{LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES, SECONDS}
+            BLOG(BLOG_LVGL_TIME);
             //Time Change
             if (data == NULL) {
                 ESP_LOGE("ERROR", "data array is NULL");
                 return;
             }
             
-            uint8_t hour = (((int)data[4] + 11) % 12) + 1; //conversion to 12-hour time
-            snprintf(buf, buf_len, "%02d:%02d", hour, (int)data[5]);
-            if((int)data[4] < 12){ //add am / pm
-                strcat(buf,"AM");
+            format_time_label(data, buf, buf_len);
+            if(clock_atlas){
+                digit_clock_set(buf);
             }
             else{
-                strcat(buf,"PM");
+                lv_label_set_text(time, buf);
             }
-            lv_label_set_text(time, buf);
+#if CLOCK_SECONDS
+            if((int)data[6] != 0){ //minute did not change, only the seconds cells went out
+                digit_clock_check_budget();
+            }
+#endif
             
-            //format date data
-            uint8_t year = (int)data[3]-2000;
-            snprintf(buf, buf_len, "%02d/%02d/%d", (int)data[2], (int)data[1],year);
-            lv_label_set_text(date, buf);
+            //format date data, setting the same text would still redraw the label
+            format_date_label(data, buf, buf_len);
+            if(strcmp(lv_label_get_text(date), buf) != 0){
+                lv_label_set_text(date, buf);
+            }
         }
         //Weather
-        else if(data_len == 4){
-            ESP_LOGI("LVGL","Updating the Weather Info");
+        else if(data_len == WEATHER_ITEM_SIZE){ //{LENGTH, TEMPERATURE, PRECIPITATION, WEATHER CODE}
+            BLOG(BLOG_LVGL_WEATHER);
             //Temperature
             snprintf(buf,buf_len,"%02d°F",(int)data[1]);
             lv_label_set_text(temp, buf);
 
             //Weather & Label
-            WeatherLabel current; 
-            if(data[3] == 0){ //if weather code fits ranges from OpenMeteo
-                current = WeatherData[0];
-            }
-            else if(data[3] > 0 && data[3] <=48){
-                current = WeatherData[1];
+            const WeatherLabel *current = weather_label(data[3]);
+            if(current != NULL){
+                lv_label_set_text(weather, current->font_label);
+                lv_label_set_text(wea_label, current->name);
             }
-            else if(data[3] > 48 && data[3] <=57){
-                current = WeatherData[2];
-            }
-            else if( (data[3] >=61 && data[3] <=67) || (data[3] >= 80 && data[3] <= 82) ){
-                current = WeatherData[3];
-            }
-            else if( (data[3] >=71 && data[3] <=77) || (data[3] >= 85 && data[3] <= 86) ){
-                current = WeatherData[4];
-            }
-            else if(data[3] >= 95){
-                current = WeatherData[5];
-            }
-            else{
-                ESP_LOGE("ERROR","CANT FIND WEATHER CODE");
-            }
-            //Weather Label
-            lv_label_set_text(weather, current.font_label);
-            lv_label_set_text(wea_label, current.name);
 
             //Precipitation Amount
             snprintf(buf,buf_len,"%.2f",data[2]);
             lv_label_set_text(precip,buf);
+
+            //Graph, only the newest column is redrawn
+            graph_page_push_now(data[1], data[2]);
             
         }
+        //Forecast
+        else if(data_len == FORECAST_ITEM_SIZE){
+            BLOG(BLOG_LVGL_FORECAST);
+            forecast_page_update(data);
+        }
+        TRACE_END(TRACE_LABEL_SET, (int)data[0]);
+        lvgl_port_unlock();
+    }
+}
+
+//Renders and flushes pending changes now instead of waiting for the LVGL task period
+void lvgl_refresh_now(void){
+    if (lvgl_port_lock(0)) {
+        lv_refr_now(NULL);
+        lvgl_port_unlock();
+    }
+}
+
+//Loads the last day from the history log into the graph page
+void lvgl_load_history(void){
+    if (lvgl_port_lock(0)) {
+        graph_page_seed();
         lvgl_port_unlock();
     }
 }
 
+//Renders pending changes and prints the now page as PBM for comparison against golden images
+void lvgl_capture(const char* name){
+    if (lvgl_port_lock(0)) {
+        lv_refr_now(NULL);
+        page_cache_dump_pbm(PAGE_NOW, name);
+        lvgl_port_unlock();
+    }
+}
 
+//Times the same minute change through the time label and through the atlas, with the bytes each sent
+//Run at boot while the now page is showing, the next time update redraws the clock
+void lvgl_clock_bench(void){
+    if (!clock_atlas || !lvgl_port_lock(0)) {
+        return;
+    }
+    lv_obj_clear_flag(time, LV_OBJ_FLAG_HIDDEN);
+    lv_label_set_text(time, "12:59PM");
+    lv_refr_now(NULL);
+    uint32_t bytes = app_metrics.panel_bytes;
+    int64_t start_us = esp_timer_get_time();
+    lv_label_set_text(time, "01:00PM");
+    lv_refr_now(NULL);
+    int64_t label_us = esp_timer_get_time() - start_us;
+    uint32_t label_bytes = app_metrics.panel_bytes - bytes;
+
+    lv_obj_add_flag(time, LV_OBJ_FLAG_HIDDEN);
+    lv_refr_now(NULL);
+    digit_clock_set("12:59PM");
+    bytes = app_metrics.panel_bytes;
+    start_us = esp_timer_get_time();
+    digit_clock_set("01:00PM");
+    int64_t atlas_us = esp_timer_get_time() - start_us;
+    uint32_t atlas_bytes = app_metrics.panel_bytes - bytes;
+
+    ESP_LOGI("CLOCK", "Label: %lld us, %lu bytes. Atlas: %lld us, %lu bytes",
+        label_us, label_bytes, atlas_us, atlas_bytes);
+    lvgl_port_unlock();
+}
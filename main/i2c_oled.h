@@ -1,8 +1,23 @@
 #ifndef i2c_oled
 #define i2c_oled
 
+#include "stddef.h"
+
+//Stores the name of a weather type and its macro font label
+typedef struct { 
+    const char* font_label;
+    const char* name;
+} WeatherLabel;
+
 void oled_init(void);
 void lvgl_init(void);
 void lvgl_update(float* data);
+void lvgl_refresh_now(void);
+void lvgl_load_history(void);
+void lvgl_capture(const char* name);
+void lvgl_clock_bench(void);
+const WeatherLabel* weather_label(float code);
+void format_time_label(const float* data, char* out, size_t len);
+void format_date_label(const float* data, char* out, size_t len);
 
 #endif // i2c_oled
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+This file builds the forecast and system stats pages
+Both follow the layout of the main page: three rows of 16 px text, 20 px apart
+Call with the LVGL lock held, the stats timer runs in the LVGL task
+*/
+
+#include "info_pages.h"
+#include "i2c_oled.h"
+#include "task_plan.h"
+#include "metrics.h"
+#include "asset_store.h"
+#include "stdio.h"
+#include "string.h"
+#include "time.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+
+#define ROW_GAP 20
+#define line_len 16
+
+//Static variables
+static lv_obj_t *day_labels[FORECAST_DAYS];
+static lv_obj_t *day_icons[FORECAST_DAYS];
+static lv_obj_t *stat_labels[3];
+static char line[line_len];
+
+//Only touches the label when the text changed, so unchanged rows are not redrawn
+static void set_text(lv_obj_t *label, const char *text){
+    if(strcmp(lv_label_get_text(label), text) != 0){
+        lv_label_set_text(label, text);
+    }
+}
+
+static lv_obj_t *row_label(lv_obj_t *parent, const lv_font_t *font, lv_align_t align, int x, int row){
+    lv_obj_t *label = lv_label_create(parent);
+    lv_label_set_text(label, "");
+    lv_obj_align(label, align, x, row * ROW_GAP);
+    lv_obj_set_style_text_font(label, font, 0);
+    return label;
+}
+
+void forecast_page_create(lv_obj_t *parent){
+    for(int i = 0; i < FORECAST_DAYS; ++i){
+        day_labels[i] = row_label(parent, asset_font(ASSET_FONT_TEXT), LV_ALIGN_TOP_LEFT, 0, i);
+        day_icons[i] = row_label(parent, asset_font(ASSET_FONT_SYMBOLS), LV_ALIGN_TOP_RIGHT, 0, i);
+    }
+    lv_label_set_text(day_labels[0], "LOADING");
+}
+
+//data is {LENGTH, MAX, MIN, CODE, ...} starting today
+void forecast_page_update(const float* data){
+    time_t now = time(NULL);
+    struct tm day;
+    for(int i = 0; i < FORECAST_DAYS; ++i){
+        time_t t = now + i * 86400;
+        localtime_r(&t, &day);
+        char name[4];
+        strftime(name, sizeof(name), "%a", &day);
+        snprintf(line, line_len, "%s %d/%d", name, (int)data[1 + i * 3], (int)data[2 + i * 3]);
+        set_text(day_labels[i], line);
+
+        const WeatherLabel *label = weather_label(data[3 + i * 3]);
+        if(label != NULL){
+            set_text(day_icons[i], label->font_label);
+        }
+    }
+}
+
+//Refreshes the numbers, the page framebuffer only changes when a value does
+static void stats_timer_cb(lv_timer_t *timer){
+    uint32_t uptime_min = esp_timer_get_time() / 60000000;
+    snprintf(line, line_len, "Up %lud%02luh%02lum", uptime_min / 1440, (uptime_min / 60) % 24, uptime_min % 60);
+    set_text(stat_labels[0], line);
+
+    snprintf(line, line_len, "Heap %uK", heap_caps_get_free_size(MALLOC_CAP_8BIT) / 1024);
+    set_text(stat_labels[1], line);
+
+    snprintf(line, line_len, "Sw %lums F%lu", app_metrics.page_switch_max_us / 1000, app_metrics.fetch_requests);
+    set_text(stat_labels[2], line);
+}
+
+void stats_page_create(lv_obj_t *parent){
+    for(int i = 0; i < 3; ++i){
+        stat_labels[i] = row_label(parent, asset_font(ASSET_FONT_TEXT), LV_ALIGN_TOP_LEFT, 0, i);
+    }
+    stats_timer_cb(NULL);
+    lv_timer_create(stats_timer_cb, STATS_REFRESH_MS, NULL);
+}
@@ -0,0 +1,13 @@
+#ifndef info_pages
+#define info_pages
+
+//No time.h here, i2c_oled.c has a label called time
+#include "lvgl.h"
+
+#define STATS_REFRESH_MS (1000 * 5)
+
+void forecast_page_create(lv_obj_t *parent);
+void forecast_page_update(const float* data);
+void stats_page_create(lv_obj_t *parent);
+
+#endif // info_pages
@@ -0,0 +1,149 @@
+/*
+This file extracts numbers from a JSON body one chunk at a time
+It is a character level scanner, not a parser: containers are matched and keys
+tracked so each number can be named, everything else goes by unstored
+*/
+
+#include "json_stream.h"
+#include "string.h"
+#include "stdlib.h"
+
+void json_stream_init(JsonStream* js, JsonNumberCb cb, void* arg){
+    memset(js, 0, sizeof(*js));
+    js->cb = cb;
+    js->arg = arg;
+}
+
+//Innermost open container, NULL at the root or past JSON_DEPTH
+static JsonFrame* top(JsonStream* js){
+    return js->depth > 0 && js->depth <= JSON_DEPTH ? &js->frames[js->depth - 1] : NULL;
+}
+
+static bool top_is_array(const JsonStream* js){
+    return js->depth > 0 && (js->arrays & (1u << (js->depth - 1)));
+}
+
+static void open_container(JsonStream* js, bool array){
+    if(js->depth >= JSON_NEST_MAX){
+        js->error = true;
+        return;
+    }
+    JsonFrame* parent = top(js);
+    bool parent_array = top_is_array(js);
+    js->arrays = array ? js->arrays | (1u << js->depth) : js->arrays & ~(1u << js->depth);
+    js->depth++;
+    js->started = true;
+    js->expect_key = !array;
+
+    JsonFrame* frame = top(js);
+    if(frame != NULL){ //arrays of objects pass the array name down
+        strcpy(frame->name, parent == NULL ? "" : parent_array ? parent->name : parent->key);
+        frame->key[0] = '\0';
+        frame->index = array ? 0 : -1;
+    }
+}
+
+static void close_container(JsonStream* js, bool array){
+    if(js->depth == 0 || top_is_array(js) != array){
+        js->error = true;
+        return;
+    }
+    js->depth--;
+    js->expect_key = false;
+}
+
+static void end_number(JsonStream* js){
+    js->in_number = false;
+    js->text[js->text_len] = '\0';
+    char *end;
+    double value = strtod(js->text, &end);
+    JsonFrame* frame = top(js);
+    if(end == js->text || *end != '\0'){
+        js->error = true;
+    }
+    else if(frame != NULL && top_is_array(js)){
+        js->cb(js->arg, js->depth > 1 ? js->frames[js->depth - 2].name : "", frame->name, frame->index, value);
+    }
+    else if(frame != NULL){
+        js->cb(js->arg, frame->name, frame->key, -1, value);
+    }
+}
+
+static void scan(JsonStream* js, char c){
+    if(js->in_string){
+        if(js->escape){
+            js->escape = false; //kept as the escaped character, keys we look for have none
+        }
+        else if(c == '\\'){
+            js->escape = true;
+            return;
+        }
+        else if(c == '"'){
+            js->in_string = false;
+            if(js->in_key && top(js) != NULL){
+                js->text[js->text_len] = '\0';
+                strcpy(top(js)->key, js->text);
+            }
+            return;
+        }
+        if(js->in_key && js->text_len < JSON_KEY_MAX - 1){
+            js->text[js->text_len++] = c;
+        }
+        return;
+    }
+    if(js->in_number){
+        if((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'){
+            if(js->text_len < JSON_KEY_MAX - 1){
+                js->text[js->text_len++] = c;
+            }
+            return;
+        }
+        end_number(js);
+    }
+
+    switch(c){
+    case '{':
+    case '[':
+        open_container(js, c == '[');
+        break;
+    case '}':
+    case ']':
+        close_container(js, c == ']');
+        break;
+    case '"':
+        js->in_string = true;
+        js->in_key = js->expect_key && !top_is_array(js);
+        js->expect_key = false;
+        js->text_len = 0;
+        break;
+    case ',':
+        if(top_is_array(js)){
+            if(top(js) != NULL){
+                top(js)->index++;
+            }
+        }
+        else{
+            js->expect_key = true;
+        }
+        break;
+    case '-':
+    case '0' ... '9':
+        js->in_number = true;
+        js->text_len = 0;
+        js->text[js->text_len++] = c;
+        break;
+    default: //whitespace, ':' and the letters of true, false and null
+        break;
+    }
+}
+
+void json_stream_push(JsonStream* js, const char* data, int len){
+    for(int i = 0; i < len && !js->error; ++i){
+        scan(js, data[i]);
+    }
+}
+
+//True once the outermost container closed and nothing was malformed
+bool json_stream_done(const JsonStream* js){
+    return js->started && js->depth == 0 && !js->error;
+}
@@ -0,0 +1,39 @@
+#ifndef json_stream
+#define json_stream
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//Scans JSON as it arrives and reports each number with the keys it sits under
+//Only the open containers, the current key and the current number are held, so the
+//body never has to fit anywhere. Strings other than keys, true, false and null are skipped.
+#define JSON_DEPTH 4      //deeper numbers are scanned past but not reported
+#define JSON_KEY_MAX 24   //longer keys are cut
+#define JSON_NEST_MAX 32  //brackets tracked for matching
+
+//object is the key of the enclosing object, "" at the root, index is the array position or -1
+//{"daily":{"weather_code":[3,61]}} reports ("daily", "weather_code", 0, 3) and ("daily", "weather_code", 1, 61)
+typedef void (*JsonNumberCb)(void* arg, const char* object, const char* key, int index, double value);
+
+typedef struct {
+    char name[JSON_KEY_MAX]; //key this container is the value of
+    char key[JSON_KEY_MAX];  //objects: key of the value being read
+    int16_t index;           //arrays: position of the value being read
+} JsonFrame;
+
+typedef struct {
+    JsonNumberCb cb;
+    void* arg;
+    JsonFrame frames[JSON_DEPTH];
+    uint8_t depth;           //containers open
+    uint32_t arrays;         //bit per depth, set for arrays
+    char text[JSON_KEY_MAX]; //key or number being read
+    uint8_t text_len;
+    bool in_string, in_key, escape, in_number, expect_key, started, error;
+} JsonStream;
+
+void json_stream_init(JsonStream* js, JsonNumberCb cb, void* arg);
+void json_stream_push(JsonStream* js, const char* data, int len);
+bool json_stream_done(const JsonStream* js);
+
+#endif // json_stream
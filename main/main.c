@@ -6,108 +6,305 @@ This is the main file for the oled weather display project
 #include "i2c_oled.h"
 #include "weather_api.h"
 #include "time_sntp.h"
+#include "refresh_policy.h"
+#include "metrics.h"
+#include "net_window.h"
+#include "task_plan.h"
+#include "event_loop.h"
+#include "history_log.h"
+#include "page_cache.h"
+#include "timewarp.h"
+#include "asset_store.h"
+#include "digit_clock.h"
+#include "blog.h"
+#include "trace.h"
 
 //ESP/C Library
 #include "stdint.h"
 #include "freertos/FreeRTOS.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "sys/time.h"
+#include "esp_timer.h"
+#include "panel_bus.h"
 
 //Macros
-#define QUEUE_LEN 5
-#define MAX_ITEM_SIZE 6
-#define API_SIZE 4
-#define ONE_HOUR_MS (1000 * 60 * 60)
+#define API_SIZE MAX_ITEM_SIZE //queue items are always MAX_ITEM_SIZE floats
 
 //Static Variables
 static float api_values[API_SIZE];
+static size_t boot_heap_free = 0;
+
+//Task stacks and control blocks, sized from task_plan.h
+#define TASK_STORAGE(id, fn, name, used, core, prio) \
+    static StackType_t id##_stack[(used) + STACK_MARGIN]; \
+    static StaticTask_t id##_tcb; \
+    static TaskHandle_t id##_handle = NULL;
+TASK_TABLE(TASK_STORAGE)
+
+static uint8_t queue_storage[QUEUE_LEN * QUEUE_ITEM_BYTES];
+static StaticQueue_t queue_buffer;
+
+_Static_assert(STATIC_RAM_TOTAL <= STATIC_RAM_BUDGET, "task_plan.h reserves more RAM than STATIC_RAM_BUDGET");
+const uint32_t static_ram_reserved = STATIC_RAM_TOTAL; //shows up in the map file and size reports
 
 //Handles
-//static TimerHandle_t wifi_status = NULL;
 static QueueHandle_t lvgl_queue;
 
-//WiFi status check task
-void wifi_status_task(void *parameter){ //temporary
+//Logs how much of each stack has been used against the table
+static void stack_report(){
+#define TASK_REPORT(id, fn, name, used, core, prio) \
+    if(id##_handle != NULL){ \
+        uint32_t peak = (used) + STACK_MARGIN - uxTaskGetStackHighWaterMark(id##_handle); \
+        if(peak > (used) + STACK_MARGIN / 2){ \
+            ESP_LOGW("STACK", "%s: peak %lu bytes, table says %d", name, peak, used); \
+        } \
+        else{ \
+            ESP_LOGI("STACK", "%s: peak %lu of %d bytes", name, peak, (used) + STACK_MARGIN); \
+        } \
+    }
+    TASK_TABLE(TASK_REPORT)
+#undef TASK_REPORT
+}
+
+//Nothing after boot should hold on to heap, fetches must give back what they take
+static void heap_check(){
+    size_t free_now = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    app_metrics.heap_delta = (int32_t)free_now - (int32_t)boot_heap_free;
+    ESP_LOGI("HEAP", "Free %u bytes, %ld since boot", free_now, app_metrics.heap_delta);
+}
+
+//Fills timeData with {LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES, SECONDS}
+static void fill_time_data(time_t *minute, float* timeData){
+    memset(timeData,0,sizeof(float) * MAX_ITEM_SIZE); //clear timeData
+    struct tm timeinfo;
+    // ESP_LOGI("MINUTE", "New minute: %d",*minute);
+    localtime_r(minute,&timeinfo);
+    if(timeinfo.tm_sec == 0){ //once a minute, also in seconds mode
+        BLOG(BLOG_TIME_NOW, timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900,
+        timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
+    }
+    
+    timeData[0] = TIME_ITEM_SIZE;
+    timeData[1] = timeinfo.tm_mday;
+    timeData[2] = timeinfo.tm_mon + 1;
+    timeData[3] = timeinfo.tm_year + 1900;
+    timeData[4] = timeinfo.tm_hour;
+    timeData[5] = timeinfo.tm_min;
+    timeData[6] = timeinfo.tm_sec;
+}
+
+//Runs one network window and returns the delay until the next one
+static uint32_t fetch_weather(esp_err_t *err){
+    *err = net_window_run(api_values); //radio is only on inside the window
+    if(*err == ESP_OK){
+        history_log_append(time(NULL), api_values);
+    }
+    uint32_t delay_ms = refresh_next_delay(api_values, *err == ESP_OK);
+    metrics_log();
+#if TRACE_ENABLE
+    trace_dump_json();
+#endif
+    stack_report();
+    heap_check();
+    return delay_ms;
+}
+
+//Renders and flushes what has been applied, time ticks also record how late the pixels changed
+static void present(bool time_item){
+    TRACE_BEGIN(TRACE_RENDER, time_item);
+    lvgl_refresh_now();
+    TRACE_END(TRACE_RENDER, time_item);
+    if(time_item){
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+#if CLOCK_SECONDS
+        metrics_record_jitter(tv.tv_usec / 1000); //late against the second boundary
+#else
+        metrics_record_jitter((tv.tv_sec % 60) * 1000 + tv.tv_usec / 1000);
+#endif
+    }
+}
+
+#if EVENT_LOOP_MODE
+static float loop_time_data[MAX_ITEM_SIZE];
+static WheelTimer second_timer;
+static WheelTimer fetch_timer;
+static esp_err_t fetch_err;
+static uint32_t fetch_delay_ms;
+
+//Draws one queue item
+static void render_cb(void* arg){
+    float* data = arg;
+    lvgl_update(data);
+    present((int)data[0] == TIME_ITEM_SIZE);
+}
+
+static void second_cb(void* arg){
+#if CLOCK_SECONDS
+    time_t now = time(NULL); //the wheel is not aligned to the second, see the task version
+    fill_time_data(&now, loop_time_data);
+    event_post(render_cb, loop_time_data, 0);
+    return;
+#endif
+    time_t *minute = increment_time();
+    if (minute != NULL) { //change time every minute
+        fill_time_data(minute, loop_time_data);
+        event_post(render_cb, loop_time_data, 0);
+    }
+}
+
+//The window takes up to ~20 s, so it runs on fetch_task and the loop keeps serving the clock meanwhile
+static void fetch_cb(void* arg){
+    xTaskNotifyGive(fetch_handle);
+}
+
+//Back on the loop once the window is over. api_values is not touched again until the timer fires.
+static void fetch_done_cb(void* arg){
+    if(fetch_err == ESP_OK){ //only show fresh values
+        render_cb(api_values);
+        if(api_forecast()[0] == FORECAST_ITEM_SIZE){
+            render_cb((void*)api_forecast());
+        }
+    }
+    event_timer_start(&fetch_timer, fetch_delay_ms, 0, fetch_cb, NULL);
+}
+
+void fetch_task(void *parameter){
     while(1){
-        check_wifi_status();
-        vTaskDelay(5000 / portTICK_PERIOD_MS);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        fetch_delay_ms = fetch_weather(&fetch_err);
+        app_metrics.task_wakeups++;
+        event_post(fetch_done_cb, NULL, portMAX_DELAY); //must not be dropped, it restarts the fetch timer
     }
 }
+#else
+//Queues one item, the trace shows how long the producer was blocked on a full queue
+static void queue_item(const float* item){
+    TRACE_BEGIN(TRACE_QUEUE_SEND, (int)item[0]);
+    xQueueSend(lvgl_queue, item, portMAX_DELAY);
+    TRACE_END(TRACE_QUEUE_SEND, (int)item[0]);
+}
 
+//Sleeps until each minute, or each second in seconds mode, starts on the system clock
 void update_time(void *parameter){ 
     float timeData[MAX_ITEM_SIZE];
     while(1){
-        time_t *minute = increment_time();
-        if (minute != NULL) { //change time every minute
-            ESP_LOGI("DEBUG", "Before: %d bytes", uxTaskGetStackHighWaterMark(NULL));
-            memset(timeData,0,MAX_ITEM_SIZE); //clear timeData
-            struct tm timeinfo;
-            // ESP_LOGI("MINUTE", "New minute: %d",*minute);
-            localtime_r(minute,&timeinfo);
-            ESP_LOGI("TIME", "Current time: %02d-%02d-%04d %02d:%02d:%02d",
-            timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900,
-            timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
-            
-            timeData[0] = MAX_ITEM_SIZE;
-            timeData[1] = timeinfo.tm_mday;
-            timeData[2] = timeinfo.tm_mon + 1;
-            timeData[3] = timeinfo.tm_year + 1900;
-            timeData[4] = timeinfo.tm_hour;
-            timeData[5] = timeinfo.tm_min;
-            // ESP_LOGI("DEBUG", "After: %d bytes", uxTaskGetStackHighWaterMark(NULL));
-            xQueueSend(lvgl_queue, timeData, portMAX_DELAY);
-            // lvgl_update(timeData);
-        }
-        vTaskDelay(1000 / portTICK_PERIOD_MS); //run every second
-        
+        time_t now = clock_wait_boundary(CLOCK_SECONDS ? 1 : 60);
+        TRACE_MARK(TRACE_TIME_WAKE, 0);
+        fill_time_data(&now, timeData);
+        queue_item(timeData);
+        app_metrics.task_wakeups++;
     }
 }
 
 void update_weather(void *parameter){ //Producer
     while(1){
-        ESP_LOGI("DEBUG", "Run api get: %d bytes", uxTaskGetStackHighWaterMark(NULL));
-        //memset(api_get,0,API_SIZE); //clear api get
-        ESP_LOGI("DEBUG", "AFTER api get 1: %d bytes", uxTaskGetStackHighWaterMark(NULL));
-        api_get(api_values);
-        ESP_LOGI("DEBUG", "AFTER api get 2: %d bytes", uxTaskGetStackHighWaterMark(NULL));
-        xQueueSend(lvgl_queue, api_values, portMAX_DELAY);
-        vTaskDelay(ONE_HOUR_MS / portTICK_PERIOD_MS); //delay for 1 hour
+        esp_err_t err;
+        TRACE_MARK(TRACE_WEATHER_WAKE, 0);
+        uint32_t delay_ms = fetch_weather(&err);
+        if(err == ESP_OK){ //only show fresh values
+            queue_item(api_values);
+            if(api_forecast()[0] == FORECAST_ITEM_SIZE){
+                queue_item(api_forecast());
+            }
+        }
+        app_metrics.task_wakeups++;
+        vTaskDelay(delay_ms / portTICK_PERIOD_MS); //delay depends on the weather
     }
 }
 
+//Applies every item waiting in the queue, then renders and flushes once for the whole burst
+//The I2C panel IO is synchronous, so present() only returns once the last transfer has left the bus.
+//The done callback just timestamps it for render_latency_us, and the next burst is picked up after that
 void send_to_lvgl(void *paramter){
     float temp[MAX_ITEM_SIZE];
     while(1){
         xQueueReceive(lvgl_queue, (void*)temp, portMAX_DELAY);
-        lvgl_update(temp);
-        vTaskDelay(1000 / portTICK_PERIOD_MS); //check every 0.8 seconds
+        int64_t start_us = esp_timer_get_time();
+        uint32_t items = 0;
+        bool time_item = false;
+        do{
+            TRACE_MARK(TRACE_QUEUE_RECV, (int)temp[0]);
+            lvgl_update(temp);
+            time_item |= (int)temp[0] == TIME_ITEM_SIZE;
+            items++;
+        } while(xQueueReceive(lvgl_queue, (void*)temp, 0) == pdTRUE);
+        present(time_item);
+
+        int64_t done_us = panel_bus_last_done_us();
+        app_metrics.render_latency_us = (done_us > start_us ? done_us : esp_timer_get_time()) - start_us;
+        if(app_metrics.render_latency_us > app_metrics.render_latency_max_us){
+            app_metrics.render_latency_max_us = app_metrics.render_latency_us;
+        }
+        if(items > app_metrics.render_burst_max_items){
+            app_metrics.render_burst_max_items = items;
+        }
+        app_metrics.render_busy_us += app_metrics.render_latency_us;
+        app_metrics.render_items += items;
+        app_metrics.render_bursts++;
+        app_metrics.task_wakeups++;
     }
 }
+#endif
 
 void app_main(void){ //setup function
     //Setup and Intialization
     oled_init();
+    asset_store_init(); //fonts must be mapped before the labels are made
     lvgl_init();
+#if DIGIT_CLOCK_BENCH
+    lvgl_clock_bench();
+#endif
     wifi_setup();
+    history_log_init();
 
     ESP_LOGI("MAIN","Intialization done");
 
     //Initial Update 
     lvgl_update(sntp_start()); //update lvgl with sntp init values
+    lvgl_load_history();
+#if TIMEWARP_SELFTEST
+    uint32_t warp_failures = timewarp_run(); //needs the TZ from sntp_start
+    if(warp_failures != 0){
+        ESP_LOGE("MAIN","Timewarp: %lu failed checks", warp_failures);
+    }
+    configASSERT(warp_failures == 0);
+#endif
+#if CAPTURE_FRAMES
+    timewarp_frames(); //the next real update overwrites the scripted labels
+#endif
     //api_get(api_values);
     //lvgl_update(api_values);
 
     ESP_LOGI("MAIN","Inital Update Done");
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
     
-    lvgl_queue = xQueueCreate(QUEUE_LEN, (sizeof(float)*MAX_ITEM_SIZE)); //max array size is 6
+    lvgl_queue = xQueueCreateStatic(QUEUE_LEN, QUEUE_ITEM_BYTES, queue_storage, &queue_buffer); //max array size is 6
 
     ESP_LOGI("MAIN","Queue Made");
+#if BLOG_BENCH_ENABLE
+    blog_bench(); //before the drain task so the bench owns the ring
+#endif
 
-    //xTaskCreate(wifi_status_task,"Wifi Status Task", 2048, NULL, 0, NULL);
-    xTaskCreate(update_time,"Get Time Task", 2048, NULL, 0, NULL); //Producer
-    xTaskCreate(update_weather, "Get Weather Task",2248,NULL,0,NULL); //Producer
-    xTaskCreate(send_to_lvgl, "Process Queue Items Task",2048,NULL,0,NULL); //Consumer
+#if EVENT_LOOP_MODE
+    event_loop_init(lvgl_queue);
+    event_timer_start(&second_timer, 1000, 1000, second_cb, NULL);
+    event_timer_start(&fetch_timer, WHEEL_TICK_MS, 0, fetch_cb, NULL);
+#endif
 
-    ESP_LOGI("MAIN","All Tasks Made");
+#define TASK_CREATE(id, fn, name, used, core, prio) \
+    id##_handle = xTaskCreateStaticPinnedToCore(fn, name, (used) + STACK_MARGIN, NULL, prio, id##_stack, &id##_tcb, core);
+    TASK_TABLE(TASK_CREATE)
+#undef TASK_CREATE
+
+    //Tasks and queue must not touch the heap, but other tasks run meanwhile so only a larger drop is reported
+    size_t heap_after = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if(heap_after + HEAP_DRIFT_MAX < heap_before){
+        ESP_LOGW("MAIN","Heap dropped %u bytes while the tasks were made", heap_before - heap_after);
+    }
+    boot_heap_free = heap_before;
+    ESP_LOGI("MAIN","All Tasks Made, %lu bytes reserved statically", static_ram_reserved);
 
     vTaskDelete(NULL); //end current task 
 } 
\ No newline at end of file
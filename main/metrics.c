@@ -0,0 +1,124 @@
+/*
+This file holds the runtime counters of the project and prints them on request
+*/
+
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "stdio.h"
+#include "string.h"
+
+app_metrics_t app_metrics;
+static const uint32_t jitter_edges[JITTER_BUCKETS] = JITTER_EDGES;
+
+//Files a minute tick that reached the panel late_ms after the minute boundary
+void metrics_record_jitter(uint32_t late_ms){
+    for(int i = 0; i < JITTER_BUCKETS; ++i){
+        if(late_ms < jitter_edges[i]){
+            app_metrics.tick_jitter_hist[i]++;
+            break;
+        }
+    }
+    if(late_ms > app_metrics.tick_jitter_max_ms){
+        app_metrics.tick_jitter_max_ms = late_ms;
+    }
+}
+
+void metrics_record_latency(uint16_t* ring, uint32_t* samples, uint32_t ms){
+    ring[*samples % LATENCY_HISTORY] = ms < UINT16_MAX ? ms : UINT16_MAX;
+    (*samples)++;
+}
+
+//Nearest rank percentile of the kept samples, 0 when there are none
+uint32_t metrics_percentile(const uint16_t* ring, uint32_t samples, uint8_t pct){
+    uint16_t sorted[LATENCY_HISTORY];
+    uint32_t kept = samples < LATENCY_HISTORY ? samples : LATENCY_HISTORY;
+    if(kept == 0){
+        return 0;
+    }
+    for(uint32_t i = 0; i < kept; ++i){ //insertion sort, 32 values at most
+        uint16_t value = ring[i];
+        uint32_t j = i;
+        for(; j > 0 && sorted[j - 1] > value; --j){
+            sorted[j] = sorted[j - 1];
+        }
+        sorted[j] = value;
+    }
+    uint32_t rank = (kept * pct + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void latency_log(const char* name, const uint16_t* ring, uint32_t samples){
+    ESP_LOGI("METRICS", "Latency %s: p50 %lu ms, p90 %lu ms, p95 %lu ms, p99 %lu ms, max %lu ms over %lu fetches", name,
+    metrics_percentile(ring, samples, 50), metrics_percentile(ring, samples, 90), metrics_percentile(ring, samples, 95),
+    metrics_percentile(ring, samples, 99), metrics_percentile(ring, samples, 100),
+    samples < LATENCY_HISTORY ? samples : LATENCY_HISTORY);
+}
+
+//Prints every counter with derived rates
+void metrics_log(){
+    uint64_t uptime_s = esp_timer_get_time() / 1000000;
+    float days = uptime_s / 86400.0f;
+
+    ESP_LOGI("METRICS", "Uptime: %llu s", uptime_s);
+    ESP_LOGI("METRICS", "Fetches: %lu (%lu failed), next in %lu ms",
+    app_metrics.fetch_requests, app_metrics.fetch_failures, app_metrics.last_refresh_ms);
+    ESP_LOGI("METRICS", "Wi-Fi: %lu ms to IP (%s), %lu disconnects", app_metrics.wifi_time_to_ip_ms,
+    app_metrics.wifi_fast_path ? "cached AP" : "full scan", app_metrics.wifi_disconnects);
+    ESP_LOGI("METRICS", "DNS cache: %lu hits, %lu misses, %lu stale",
+    app_metrics.dns_hits, app_metrics.dns_misses, app_metrics.dns_stale);
+    ESP_LOGI("METRICS", "Largest free block: %lu bytes (lowest %lu), heap %ld since boot",
+    app_metrics.largest_free_block, app_metrics.largest_free_block_min, app_metrics.heap_delta);
+    ESP_LOGI("METRICS", "Tick jitter (ms) <10:%lu <50:%lu <100:%lu <250:%lu <500:%lu <1000:%lu more:%lu max:%lu",
+    app_metrics.tick_jitter_hist[0], app_metrics.tick_jitter_hist[1], app_metrics.tick_jitter_hist[2],
+    app_metrics.tick_jitter_hist[3], app_metrics.tick_jitter_hist[4], app_metrics.tick_jitter_hist[5],
+    app_metrics.tick_jitter_hist[6], app_metrics.tick_jitter_max_ms);
+    ESP_LOGI("METRICS", "History: %lu records, %lu erases, write %lu us, last query %lu us over %lu sectors",
+    app_metrics.history_records, app_metrics.history_erases, app_metrics.history_write_us,
+    app_metrics.history_query_us, app_metrics.history_query_sectors);
+    ESP_LOGI("METRICS", "Pages: %lu switches, last %lu us, max %lu us",
+    app_metrics.page_switches, app_metrics.page_switch_us, app_metrics.page_switch_max_us);
+    ESP_LOGI("METRICS", "Panel bus: %lu transactions, %lu bytes, ~%llu ms, %lu redundant bytes, %lu transfers done",
+    app_metrics.panel_transactions, app_metrics.panel_bytes, app_metrics.panel_bus_us / 1000,
+    app_metrics.panel_redundant_bytes, app_metrics.panel_flushes_done);
+    ESP_LOGI("METRICS", "Render: %lu bursts, %lu items, max %lu per burst, latency %lu us (max %lu us), %.1f items/s while busy",
+    app_metrics.render_bursts, app_metrics.render_items, app_metrics.render_burst_max_items,
+    app_metrics.render_latency_us, app_metrics.render_latency_max_us,
+    app_metrics.render_busy_us > 0 ? app_metrics.render_items * 1e6f / app_metrics.render_busy_us : 0.0f);
+    ESP_LOGI("METRICS", "Clock: last change %lu us, max %lu us, %lu bytes, %lu us bus, %lu over budget",
+    app_metrics.clock_render_us, app_metrics.clock_render_max_us, app_metrics.clock_bytes,
+    app_metrics.clock_bus_us, app_metrics.clock_overruns);
+    char offsets[CLOCK_OFFSET_HISTORY * 8] = "";
+    uint32_t kept = app_metrics.clock_syncs < CLOCK_OFFSET_HISTORY ? app_metrics.clock_syncs : CLOCK_OFFSET_HISTORY;
+    for(uint32_t i = app_metrics.clock_syncs - kept; i < app_metrics.clock_syncs; ++i){ //oldest first
+        size_t used = strlen(offsets);
+        snprintf(offsets + used, sizeof(offsets) - used, " %ld", app_metrics.clock_offset_ms[i % CLOCK_OFFSET_HISTORY]);
+    }
+    ESP_LOGI("METRICS", "Clock: drift %.2f ppm, %lu syncs, %lu steps, offsets ms:%s",
+    app_metrics.clock_drift_ppm, app_metrics.clock_syncs, app_metrics.clock_steps, offsets);
+    ESP_LOGI("METRICS", "Binary log: %lu records, %lu dropped, %lu UART bytes",
+    app_metrics.blog_records, app_metrics.blog_dropped, app_metrics.blog_bytes);
+    ESP_LOGI("METRICS", "TLS: %lu handshakes, %lu resumed, last full %lu ms, last resumed %lu ms, heap peak %lu bytes, %lu failed",
+    app_metrics.tls_handshakes, app_metrics.tls_resumed, app_metrics.tls_full_ms,
+    app_metrics.tls_resumed_ms, app_metrics.tls_heap_peak, app_metrics.tls_failures);
+    ESP_LOGI("METRICS", "Body: %lu bytes received, %lu bytes JSON%s, %lu bytes RAM + %lu heap peak, %lu gzip failures",
+    app_metrics.fetch_wire_bytes, app_metrics.fetch_body_bytes, app_metrics.fetch_gzip ? " (gzip)" : "",
+    app_metrics.fetch_body_ram, app_metrics.tls_heap_peak, app_metrics.gzip_failures);
+    ESP_LOGI("METRICS", "Providers: %lu hedges, %lu answered by the backup, %lu primary failures, deadline %lu ms",
+    app_metrics.hedges, app_metrics.hedge_wins, app_metrics.primary_failures, app_metrics.hedge_deadline_ms);
+    latency_log("primary", app_metrics.primary_ms, app_metrics.primary_samples);
+    latency_log("answer", app_metrics.answer_ms, app_metrics.answer_samples);
+    ESP_LOGI("METRICS", "Event loop: %lu events dropped", app_metrics.loop_events_dropped);
+    if(uptime_s >= 3600){
+        ESP_LOGI("METRICS", "Task wakeups: %llu/hour", (uint64_t)app_metrics.task_wakeups * 3600 / uptime_s);
+        ESP_LOGI("METRICS", "Radio on: %llu ms/hour over %lu windows",
+        app_metrics.radio_on_ms * 3600 / uptime_s, app_metrics.net_windows);
+    }
+    if(days > 0){
+        ESP_LOGI("METRICS", "Requests/day: %.1f", app_metrics.fetch_requests / days);
+    }
+    if(app_metrics.staleness_span_s > 0){
+        ESP_LOGI("METRICS", "Average staleness: %llu s",
+        app_metrics.staleness_s2 / app_metrics.staleness_span_s);
+    }
+}
@@ -0,0 +1,125 @@
+#ifndef metrics
+#define metrics
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//Counters collected across the modules, printed with metrics_log()
+//Minute tick jitter histogram, upper bucket edges in ms
+#define JITTER_BUCKETS 7
+#define JITTER_EDGES {10, 50, 100, 250, 500, 1000, UINT32_MAX}
+#define CLOCK_OFFSET_HISTORY 8
+#define LATENCY_HISTORY 32 //fetch latencies kept for the percentiles
+
+typedef struct {
+    //Weather refresh
+    uint32_t fetch_requests;
+    uint32_t fetch_failures;
+    uint32_t last_refresh_ms;
+    uint64_t staleness_s2;     //integral of data age over time (s^2)
+    uint64_t staleness_span_s; //time covered by staleness_s2
+
+    //Wi-Fi
+    uint32_t wifi_time_to_ip_ms;
+    uint32_t wifi_disconnects;
+    bool wifi_fast_path;       //last connect used the cached AP and lease
+    uint64_t radio_on_ms;      //time spent inside network windows
+    uint32_t net_windows;
+
+    //DNS cache
+    uint32_t dns_hits;
+    uint32_t dns_misses;
+    uint32_t dns_stale;        //lookups served an expired address, or any before the clock is set
+
+    //Memory
+    int32_t heap_delta;        //free heap now minus free heap at the end of boot
+    uint32_t largest_free_block;
+    uint32_t largest_free_block_min;
+
+    //Minute tick: scheduled minute boundary to pixels changed
+    uint32_t tick_jitter_hist[JITTER_BUCKETS];
+    uint32_t tick_jitter_max_ms;
+
+    //History log
+    uint32_t history_records;
+    uint32_t history_erases;
+    uint32_t history_write_us; //last record write
+    uint32_t history_query_us;
+    uint32_t history_query_sectors; //sectors decoded by the last query
+
+    //Display pages
+    uint32_t page_switches;
+    uint32_t page_switch_us;   //last page switch, one full frame blit
+    uint32_t page_switch_max_us;
+
+    //Panel bus, from the GDDRAM model in panel_bus.c
+    uint32_t panel_transactions;
+    uint32_t panel_bytes;
+    uint64_t panel_bus_us;     //estimated at PANEL_SCL_HZ
+    uint32_t panel_redundant_bytes; //written with the value the panel already had
+    uint32_t panel_flushes_done;    //pixel transfers reported done by the panel IO
+
+    //Render bursts, every queued item pending at once is applied before one refresh
+    uint32_t render_bursts;
+    uint32_t render_items;
+    uint32_t render_burst_max_items;
+    uint32_t render_latency_us;     //last burst, first item received to last transfer done
+    uint32_t render_latency_max_us;
+    uint64_t render_busy_us;        //sum of the burst latencies
+
+    //Clock atlas, one minute change
+    uint32_t clock_render_us;  //cells copied and sent
+    uint32_t clock_render_max_us;
+    uint32_t clock_bytes;      //panel bytes of the last change
+    uint32_t clock_bus_us;
+    uint32_t clock_overruns;   //seconds-only changes over the CLOCK_SECOND budget
+
+    //Clock discipline, offsets are server minus local time at each SNTP sync after boot
+    uint32_t clock_syncs;
+    uint32_t clock_steps;      //offsets over CLOCK_STEP_MS, stepped instead of slewed
+    int32_t clock_offset_ms[CLOCK_OFFSET_HISTORY]; //ring, clock_syncs is the next slot
+    float clock_drift_ppm;     //positive when the local clock runs slow
+
+    //Binary log
+    uint32_t blog_records;
+    uint32_t blog_dropped;     //overwritten before the drain task got to them
+    uint32_t blog_bytes;       //sent over the UART
+
+    //TLS to the weather API
+    uint32_t tls_handshakes;
+    uint32_t tls_resumed;      //finished on the saved session, no certificate exchange
+    uint32_t tls_full_ms;      //last full handshake
+    uint32_t tls_resumed_ms;   //last resumed handshake
+    uint32_t tls_failures;
+    uint32_t tls_heap_peak;    //most heap a fetch held, from the heap's minimum free size while it ran
+
+    //Response body of the last fetch
+    uint32_t fetch_wire_bytes; //received, with TLS records and headers on the HTTPS path, body only on plain HTTP
+    uint32_t fetch_body_bytes; //JSON, after inflating
+    uint32_t fetch_body_ram;   //static RAM the body path holds: a scanner per provider, plus window and tables with gzip
+    bool fetch_gzip;
+    uint32_t gzip_failures;
+
+    //Providers, latencies run from the request to the end of a complete response
+    uint32_t hedges;           //backup requests started
+    uint32_t hedge_wins;       //answered by the backup
+    uint32_t primary_failures;
+    uint32_t hedge_deadline_ms; //last one used
+    uint16_t primary_ms[LATENCY_HISTORY]; //ring, primary_samples is the next slot. A primary dropped for the backup counts with the time it ran
+    uint32_t primary_samples;
+    uint16_t answer_ms[LATENCY_HISTORY];  //first valid answer, what the display waited for
+    uint32_t answer_samples;
+
+    //Scheduling, one wakeup is one switch into a project task
+    uint32_t task_wakeups;
+    uint32_t loop_events_dropped; //event_post found the loop queue full
+} app_metrics_t;
+
+extern app_metrics_t app_metrics;
+
+void metrics_log();
+void metrics_record_jitter(uint32_t late_ms);
+void metrics_record_latency(uint16_t* ring, uint32_t* samples, uint32_t ms);
+uint32_t metrics_percentile(const uint16_t* ring, uint32_t samples, uint8_t pct);
+
+#endif // metrics
@@ -0,0 +1,48 @@
+/*
+This file groups all outbound network work into one window:
+radio up, DNS, time sync, weather fetch, then radio back to sleep
+*/
+
+#include "net_window.h"
+#include "weather_api.h"
+#include "time_sntp.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+#include "dns_cache.h"
+
+static void radio_sleep(){
+#if WINDOW_RADIO_OFF
+    wifi_down();
+#else
+    esp_wifi_set_ps(WIFI_PS_MAX_MODEM);
+#endif
+}
+
+//Runs the whole window, returns the result of the weather fetch
+esp_err_t net_window_run(float* api_values){
+    int64_t start_us = esp_timer_get_time();
+    esp_err_t err;
+
+#if !WINDOW_RADIO_OFF
+    esp_wifi_set_ps(WIFI_PS_NONE); //full speed while the window is open
+#endif
+    err = wifi_up(WINDOW_WIFI_TIMEOUT_MS);
+    if(err == ESP_OK){
+        check_wifi_status();
+        dns_cache_refresh();
+        sntp_resync(WINDOW_SNTP_TIMEOUT_MS);
+        err = api_get(api_values);
+    }
+    else{
+        ESP_LOGW("WINDOW", "No Wi-Fi, skipping this window");
+    }
+    radio_sleep();
+
+    uint32_t on_ms = (esp_timer_get_time() - start_us) / 1000;
+    app_metrics.radio_on_ms += on_ms;
+    app_metrics.net_windows++;
+    ESP_LOGI("WINDOW", "Window done in %lu ms", on_ms);
+    return err;
+}
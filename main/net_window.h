@@ -0,0 +1,15 @@
+#ifndef net_window
+#define net_window
+
+#include "esp_err.h"
+
+//Time limits for each step of the window
+#define WINDOW_WIFI_TIMEOUT_MS (1000 * 15)
+#define WINDOW_SNTP_TIMEOUT_MS (1000 * 5)
+
+//1 turns Wi-Fi off between windows, 0 leaves it associated in modem sleep
+#define WINDOW_RADIO_OFF 1
+
+esp_err_t net_window_run(float* api_values);
+
+#endif // net_window
@@ -0,0 +1,161 @@
+/*
+This file keeps every page of the UI rendered in its own packed 1 KB framebuffer
+Each page is a separate LVGL display rendering straight into its framebuffer in the
+SSD1306 page layout, so inactive pages stay up to date in the background.
+Dirty areas of the visible page are sent to the panel as they are rendered,
+and switching pages is a single full frame blit.
+Black is a lit pixel, same as the esp_lvgl_port monochrome driver.
+*/
+
+#include "page_cache.h"
+#include "panel_bus.h"
+#include "metrics.h"
+#include "trace.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/gpio.h"
+#include "stdio.h"
+
+typedef struct {
+    lv_disp_drv_t drv;
+    lv_disp_draw_buf_t draw_buf;
+    lv_disp_t *disp;
+    PageOverlay overlay;
+    uint8_t fb[PAGE_FB_SIZE];
+} Page;
+
+//Static variables
+static Page pages[PAGE_COUNT];
+static PageId active = PAGE_NOW;
+
+//Writes one pixel into the packed framebuffer, direct mode gives screen coordinates
+static void page_set_px(lv_disp_drv_t *drv, uint8_t *buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                        lv_color_t color, lv_opa_t opa){
+    uint8_t *byte = &buf[(y >> 3) * PAGE_H_RES + x];
+    if(lv_color_brightness(color) < 128){
+        *byte |= 1 << (y & 7);
+    }
+    else{
+        *byte &= ~(1 << (y & 7));
+    }
+}
+
+//Areas always cover whole 8 row pages so they map onto panel writes
+static void page_rounder(lv_disp_drv_t *drv, lv_area_t *area){
+    area->y1 &= ~7;
+    area->y2 |= 7;
+}
+
+//Sends the rows of an area that live in the framebuffer to the panel
+static void send_area(const uint8_t *fb, const lv_area_t *area){
+    int page1 = area->y1 >> 3;
+    panel_bus_write(area->x1, page1, area->x2, area->y2 >> 3, &fb[page1 * PAGE_H_RES + area->x1], PAGE_H_RES);
+}
+
+//The framebuffer already holds the pixels, only the visible page goes out over I2C
+static void page_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_map){
+    Page *page = drv->user_data;
+    if(page->overlay != NULL){
+        page->overlay(page->fb, area);
+    }
+    if(page == &pages[active]){
+        TRACE_BEGIN(TRACE_FLUSH, page - pages);
+        send_area(page->fb, area);
+        TRACE_END(TRACE_FLUSH, page - pages);
+    }
+    lv_disp_flush_ready(drv);
+}
+
+//Polls the button and rotates pages, runs in the LVGL task like the flushes
+static void page_timer_cb(lv_timer_t *timer){
+    static uint32_t shown_ms = 0;
+    static int last_level = 1;
+    int level = gpio_get_level(PAGE_BUTTON_GPIO);
+    bool pressed = level == 0 && last_level == 1;
+    last_level = level;
+
+    shown_ms += PAGE_POLL_MS;
+    if(pressed || shown_ms >= PAGE_ROTATE_MS){
+        shown_ms = 0;
+        page_cache_show((active + 1) % PAGE_COUNT);
+    }
+}
+
+//Registers one LVGL display per page, the panel must already be on
+void page_cache_init(esp_lcd_panel_handle_t panel){
+    panel_bus_init(panel);
+    for(int i = 0; i < PAGE_COUNT; ++i){
+        Page *page = &pages[i];
+        lv_disp_draw_buf_init(&page->draw_buf, page->fb, NULL, PAGE_H_RES * PAGE_V_RES);
+        lv_disp_drv_init(&page->drv);
+        page->drv.hor_res = PAGE_H_RES;
+        page->drv.ver_res = PAGE_V_RES;
+        page->drv.draw_buf = &page->draw_buf;
+        page->drv.direct_mode = 1;
+        page->drv.set_px_cb = page_set_px;
+        page->drv.rounder_cb = page_rounder;
+        page->drv.flush_cb = page_flush;
+        page->drv.user_data = page;
+        page->disp = lv_disp_drv_register(&page->drv);
+    }
+    lv_disp_set_default(pages[PAGE_NOW].disp);
+
+    gpio_config_t button = {
+        .pin_bit_mask = 1ULL << PAGE_BUTTON_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+    };
+    gpio_config(&button);
+    lv_timer_create(page_timer_cb, PAGE_POLL_MS, NULL);
+}
+
+lv_obj_t *page_cache_screen(PageId page){
+    return lv_disp_get_scr_act(pages[page].disp);
+}
+
+PageId page_cache_active(){
+    return active;
+}
+
+//Makes page visible with one blit of its framebuffer, call from the LVGL task or with the LVGL lock
+void page_cache_show(PageId page){
+    int64_t start_us = esp_timer_get_time();
+    active = page;
+    panel_bus_write(0, 0, PAGE_H_RES - 1, PAGE_V_RES / 8 - 1, pages[page].fb, PAGE_H_RES);
+    app_metrics.page_switch_us = esp_timer_get_time() - start_us;
+    if(app_metrics.page_switch_us > app_metrics.page_switch_max_us){
+        app_metrics.page_switch_max_us = app_metrics.page_switch_us;
+    }
+    app_metrics.page_switches++;
+}
+
+//Prints the framebuffer of page as a plain PBM (P1) between markers, lit pixels are 1
+//name ends up in the file name, call from the LVGL task or with the LVGL lock so the frame is not half rendered
+void page_cache_dump_pbm(PageId page, const char *name){
+    static char row[PAGE_H_RES + 1];
+    const uint8_t *fb = pages[page].fb;
+    printf("PBM BEGIN %d %s\nP1\n%d %d\n", page, name, PAGE_H_RES, PAGE_V_RES);
+    for(int y = 0; y < PAGE_V_RES; ++y){
+        for(int x = 0; x < PAGE_H_RES; ++x){
+            row[x] = (fb[(y >> 3) * PAGE_H_RES + x] >> (y & 7)) & 1 ? '1' : '0';
+        }
+        row[PAGE_H_RES] = '\0';
+        printf("%s\n", row);
+    }
+    printf("PBM END\n");
+}
+
+uint8_t *page_cache_fb(PageId page){
+    return pages[page].fb;
+}
+
+//Sends a column and page range of a framebuffer written outside LVGL, nothing if the page is hidden
+void page_cache_send(PageId page, int x1, int page1, int x2, int page2){
+    if(page == active){
+        panel_bus_write(x1, page1, x2, page2, &pages[page].fb[page1 * PAGE_H_RES + x1], PAGE_H_RES);
+    }
+}
+
+void page_cache_set_overlay(PageId page, PageOverlay overlay){
+    pages[page].overlay = overlay;
+}
@@ -0,0 +1,42 @@
+#ifndef page_cache
+#define page_cache
+
+#include "stdint.h"
+#include "lvgl.h"
+#include "esp_lcd_panel_ops.h"
+
+//Panel size, one packed framebuffer is 128 columns x 8 pages of 8 rows
+#define PAGE_H_RES 128
+#define PAGE_V_RES 64
+#define PAGE_FB_SIZE (PAGE_H_RES * PAGE_V_RES / 8)
+
+//Automatic rotation period and the button that skips to the next page
+#define PAGE_ROTATE_MS (1000 * 10)
+#define PAGE_BUTTON_GPIO GPIO_NUM_0
+#define PAGE_POLL_MS 50
+
+//1 feeds the fixed updates of timewarp_frames() through lvgl_update at boot and prints the now page
+//as a PBM image after each one, see tools/pbm_capture.py for the comparison against tools/frames
+#define CAPTURE_FRAMES 0
+
+typedef enum {
+    PAGE_NOW,
+    PAGE_FORECAST,
+    PAGE_HISTORY,
+    PAGE_STATS,
+    PAGE_COUNT
+} PageId;
+
+//Draws pixels LVGL does not own into a page, called before each flushed area is sent
+typedef void (*PageOverlay)(uint8_t *fb, const lv_area_t *area);
+
+void page_cache_init(esp_lcd_panel_handle_t panel);
+lv_obj_t *page_cache_screen(PageId page);
+void page_cache_show(PageId page);
+PageId page_cache_active();
+void page_cache_dump_pbm(PageId page, const char *name);
+uint8_t *page_cache_fb(PageId page);
+void page_cache_send(PageId page, int x1, int page1, int x2, int page2);
+void page_cache_set_overlay(PageId page, PageOverlay overlay);
+
+#endif // page_cache
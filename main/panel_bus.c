@@ -0,0 +1,164 @@
+/*
+This file is the only path from the UI to the SSD1306
+It wraps the tx_param and tx_color hooks of the panel IO, so every transaction the
+driver sends, init included, is counted with its real length. The addressing commands
+are decoded from the same stream to keep a model of the panel's GDDRAM, which flags
+data bytes that rewrite a pixel column with the value it already had
+*/
+
+#include "panel_bus.h"
+#include "page_cache.h"
+#include "metrics.h"
+#include "string.h"
+#include "esp_timer.h"
+#include "esp_lcd_panel_io_interface.h"
+
+//SSD1306 commands that move the GDDRAM pointer
+#define SSD1306_ADDR_MODE 0x20
+#define SSD1306_COLUMN_RANGE 0x21
+#define SSD1306_PAGE_RANGE 0x22
+#define SSD1306_PAGE_START 0xB0   //page addressing mode, low 3 bits are the page
+#define SSD1306_COLUMN_LOW 0x00   //page addressing mode, low nibble of the column
+#define SSD1306_COLUMN_HIGH 0x10  //page addressing mode, high nibble of the column
+#define PANEL_PAGES (PAGE_V_RES / 8)
+
+typedef enum{
+    ADDR_HORIZONTAL = 0,
+    ADDR_VERTICAL = 1,
+    ADDR_PAGE = 2,  //reset default of the SSD1306
+} AddrMode;
+
+//Static variables
+static esp_lcd_panel_handle_t panel_handle = NULL;
+static esp_err_t (*io_tx_param)(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size) = NULL;
+static esp_err_t (*io_tx_color)(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size) = NULL;
+static uint8_t gddram[PAGE_FB_SIZE];       //what the panel currently shows
+static uint8_t known[PAGE_FB_SIZE / 8];    //one bit per GDDRAM byte, set once it has been written
+static AddrMode addr_mode = ADDR_PAGE;
+static uint8_t column = 0, column_start = 0, column_end = PAGE_H_RES - 1;
+static uint8_t page = 0, page_start = 0, page_end = PANEL_PAGES - 1;
+static int64_t last_done_us = 0;
+
+//Adds one I2C transaction of len bytes after the address
+static void account(uint32_t len){
+    uint32_t bits = PANEL_TRANSACTION_BITS(len);
+    app_metrics.panel_transactions++;
+    app_metrics.panel_bytes += PANEL_ADDR_BYTES + len;
+    app_metrics.panel_bus_us += (uint64_t)bits * 1000000 / PANEL_SCL_HZ;
+}
+
+//Updates the GDDRAM pointer for one command with its parameters
+static void decode_command(int lcd_cmd, const uint8_t *param, size_t param_size){
+    if(lcd_cmd == SSD1306_ADDR_MODE && param_size >= 1){
+        addr_mode = param[0] & 0x03;
+    }
+    else if(lcd_cmd == SSD1306_COLUMN_RANGE && param_size >= 2){
+        column_start = column = param[0] & 0x7F;
+        column_end = param[1] & 0x7F;
+    }
+    else if(lcd_cmd == SSD1306_PAGE_RANGE && param_size >= 2){
+        page_start = page = param[0] & 0x07;
+        page_end = param[1] & 0x07;
+    }
+    else if(addr_mode == ADDR_PAGE && param_size == 0){
+        if((lcd_cmd & 0xF8) == SSD1306_PAGE_START){
+            page = lcd_cmd & 0x07;
+        }
+        else if((lcd_cmd & 0xF0) == SSD1306_COLUMN_LOW){
+            column = (column & 0xF0) | (lcd_cmd & 0x0F);
+        }
+        else if((lcd_cmd & 0xF0) == SSD1306_COLUMN_HIGH){
+            column = ((lcd_cmd & 0x07) << 4) | (column & 0x0F);
+        }
+    }
+}
+
+//Moves the GDDRAM pointer past one data byte the way the panel does in each mode
+static void advance(){
+    switch(addr_mode){
+    case ADDR_HORIZONTAL:
+        if(column++ >= column_end){
+            column = column_start;
+            page = page >= page_end ? page_start : page + 1;
+        }
+        break;
+    case ADDR_VERTICAL:
+        if(page++ >= page_end){
+            page = page_start;
+            column = column >= column_end ? column_start : column + 1;
+        }
+        break;
+    default: //page mode stays on its page and wraps the column
+        column = (column + 1) % PAGE_H_RES;
+        break;
+    }
+}
+
+//Writes the data bytes into the model at the GDDRAM pointer
+static void decode_data(const uint8_t *data, size_t len){
+    for(size_t i = 0; i < len; ++i){
+        if(page < PANEL_PAGES && column < PAGE_H_RES){
+            int at = page * PAGE_H_RES + column;
+            uint8_t bit = 1 << (at & 7);
+            if((known[at >> 3] & bit) && gddram[at] == data[i]){
+                app_metrics.panel_redundant_bytes++;
+            }
+            gddram[at] = data[i];
+            known[at >> 3] |= bit;
+        }
+        advance();
+    }
+}
+
+//Wrapped panel IO hooks, the I2C transaction is the control byte, the command if any, then the payload
+static esp_err_t bus_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param, size_t param_size){
+    account(PANEL_CONTROL_BYTES + (lcd_cmd >= 0 ? 1 : 0) + param_size);
+    decode_command(lcd_cmd, param, param_size);
+    return io_tx_param(io, lcd_cmd, param, param_size);
+}
+
+static esp_err_t bus_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color, size_t color_size){
+    account(PANEL_CONTROL_BYTES + (lcd_cmd >= 0 ? 1 : 0) + color_size);
+    decode_data(color, color_size);
+    return io_tx_color(io, lcd_cmd, color, color_size);
+}
+
+//Hooks the panel IO, call before the SSD1306 driver is installed so its init is counted too
+//The hooks are swapped in place because the I2C IO finds its own state from the io pointer
+void panel_bus_attach(esp_lcd_panel_io_handle_t io){
+    io_tx_param = io->tx_param;
+    io_tx_color = io->tx_color;
+    io->tx_param = bus_tx_param;
+    io->tx_color = bus_tx_color;
+}
+
+void panel_bus_init(esp_lcd_panel_handle_t panel){
+    panel_handle = panel;
+}
+
+//Writes columns x1..x2 of pages page1..page2, data points at (x1, page1) with stride bytes per page
+//One draw_bitmap per page keeps the data contiguous for the driver
+void panel_bus_write(int x1, int page1, int x2, int page2, const uint8_t *data, int stride){
+    int width = x2 - x1 + 1;
+    bool full = x1 == 0 && width == PAGE_H_RES && page1 == 0 && page2 == PANEL_PAGES - 1;
+
+    if(full){ //full frames go out as one transfer
+        esp_lcd_panel_draw_bitmap(panel_handle, 0, 0, PAGE_H_RES, PAGE_V_RES, data);
+        return;
+    }
+    for(int p = page1; p <= page2; ++p){
+        esp_lcd_panel_draw_bitmap(panel_handle, x1, p * 8, x2 + 1, p * 8 + 8, data + (p - page1) * stride);
+    }
+}
+
+//Panel IO callback, runs once the pixel data of a draw_bitmap has left the bus
+bool panel_bus_flush_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx){
+    last_done_us = esp_timer_get_time();
+    app_metrics.panel_flushes_done++;
+    return false;
+}
+
+//esp_timer time of the last completed pixel transfer
+int64_t panel_bus_last_done_us(){
+    return last_done_us;
+}
@@ -0,0 +1,32 @@
+#ifndef panel_bus
+#define panel_bus
+
+#include "stdint.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_lcd_panel_io.h"
+
+//I2C clock of the panel, used for the bus time estimate
+#define PANEL_SCL_HZ (400 * 1000)
+
+//What esp_lcd_panel_ssd1306 puts on the bus for one draw_bitmap, each part is its own transaction:
+//column range and page range commands (control byte, command, 2 parameters), then control byte and data
+//panel_bus.c counts the real transactions from the panel IO, these are for budgets made ahead of time
+#define PANEL_CMD_BYTES 4
+#define PANEL_ADDR_BYTES 1
+#define PANEL_CONTROL_BYTES 1
+#define PANEL_BITS_PER_BYTE 9   //8 data bits and the ACK
+#define PANEL_BITS_PER_FRAME 2  //start and stop condition
+
+//Cost of one transaction of len bytes after the address, and of a draw_bitmap of width columns on one page
+#define PANEL_TRANSACTION_BITS(len) ((PANEL_ADDR_BYTES + (len)) * PANEL_BITS_PER_BYTE + PANEL_BITS_PER_FRAME)
+#define PANEL_DRAW_BYTES(width) (3 * PANEL_ADDR_BYTES + 2 * PANEL_CMD_BYTES + PANEL_CONTROL_BYTES + (width))
+#define PANEL_DRAW_US(width) ((2 * PANEL_TRANSACTION_BITS(PANEL_CMD_BYTES) + \
+    PANEL_TRANSACTION_BITS(PANEL_CONTROL_BYTES + (width))) * 1000000ULL / PANEL_SCL_HZ)
+
+void panel_bus_attach(esp_lcd_panel_io_handle_t io);
+void panel_bus_init(esp_lcd_panel_handle_t panel);
+void panel_bus_write(int x1, int page1, int x2, int page2, const uint8_t *data, int stride);
+bool panel_bus_flush_done(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t *edata, void *user_ctx);
+int64_t panel_bus_last_done_us();
+
+#endif // panel_bus
@@ -0,0 +1,120 @@
+/*
+This file decides when the next weather fetch should run
+Volatile weather (temperature/precipitation changes, severe weather codes) shortens the delay,
+calm weather stretches it, and failed fetches back off exponentially with jitter
+*/
+
+#include "refresh_policy.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+
+//Change per hour that counts as one unit of volatility
+#define TEMP_STEP_F 2.0f
+#define PRECIP_STEP_IN 0.05f
+#define CALM_GROWTH 1.5f
+
+//Static variables
+static float last_temp;
+static float last_precip;
+static bool have_sample = false;
+static int64_t last_success_us = 0;
+static uint32_t last_delay_ms = REFRESH_BASE_MS;
+static uint8_t failures = 0;
+
+//Severity of an Open Meteo weather code, same ranges as the display
+static float code_severity(float code){
+    if(code >= 95){ //thunderstorm
+        return 3;
+    }
+    if( (code >= 61 && code <= 67) || (code >= 71 && code <= 86) ){ //rain or snow
+        return 2;
+    }
+    if(code > 48 && code <= 57){ //drizzle
+        return 1;
+    }
+    return 0;
+}
+
+//Adds +-BACKOFF_JITTER_PCT percent to a delay
+static uint32_t add_jitter(uint32_t delay_ms, uint8_t pct){
+    uint32_t span = (delay_ms / 100) * pct;
+    if(span == 0){
+        return delay_ms;
+    }
+    return delay_ms - span + (esp_random() % (2 * span));
+}
+
+static uint32_t clamp_delay(uint32_t delay_ms){
+    if(delay_ms < REFRESH_MIN_MS){
+        return REFRESH_MIN_MS;
+    }
+    if(delay_ms > REFRESH_MAX_MS){
+        return REFRESH_MAX_MS;
+    }
+    return delay_ms;
+}
+
+//Updates the staleness counters, the data age grows linearly until the next good fetch
+static void record_staleness(int64_t now_us){
+    if(last_success_us != 0){
+        uint64_t span_s = (now_us - last_success_us) / 1000000;
+        app_metrics.staleness_s2 += span_s * span_s / 2;
+        app_metrics.staleness_span_s += span_s;
+    }
+    last_success_us = now_us;
+}
+
+//Returns the delay in ms until the next fetch
+//api_values is {LENGTH, TEMPERATURE, PRECIPITATION, WEATHER CODE}
+uint32_t refresh_next_delay(const float* api_values, bool fetch_ok){
+    int64_t now_us = esp_timer_get_time();
+    uint32_t delay_ms;
+
+    app_metrics.fetch_requests++;
+    if(!fetch_ok){ //exponential backoff, ignoring the volatility bounds
+        app_metrics.fetch_failures++;
+        delay_ms = add_jitter(BACKOFF_START_MS << (failures < 8 ? failures : 8), BACKOFF_JITTER_PCT);
+        if(delay_ms > REFRESH_MAX_MS){ //after the jitter, which can push it past
+            delay_ms = REFRESH_MAX_MS;
+        }
+        if(failures < UINT8_MAX){ //saturates, a wrap would restart the backoff at its shortest
+            failures++;
+        }
+        ESP_LOGW("REFRESH", "Fetch failed %d times, retry in %lu ms", failures, delay_ms);
+        app_metrics.last_refresh_ms = delay_ms;
+        return delay_ms;
+    }
+    failures = 0;
+
+    float volatility = code_severity(api_values[3]);
+    if(have_sample){
+        float hours = (now_us - last_success_us) / 3600e6f;
+        if(hours < 0.1f){
+            hours = 0.1f;
+        }
+        float dtemp = api_values[1] - last_temp;
+        float dprecip = api_values[2] - last_precip;
+        volatility += (dtemp < 0 ? -dtemp : dtemp) / hours / TEMP_STEP_F;
+        volatility += (dprecip < 0 ? -dprecip : dprecip) / hours / PRECIP_STEP_IN;
+    }
+    record_staleness(now_us);
+
+    last_temp = api_values[1];
+    last_precip = api_values[2];
+    have_sample = true;
+
+    if(volatility < 0.5f){ //calm, stretch the previous delay
+        delay_ms = last_delay_ms * CALM_GROWTH;
+    }
+    else{
+        delay_ms = REFRESH_BASE_MS / (1.0f + volatility);
+    }
+    delay_ms = clamp_delay(add_jitter(delay_ms, 10));
+    last_delay_ms = delay_ms;
+
+    ESP_LOGI("REFRESH", "Volatility %.2f, next fetch in %lu s", volatility, delay_ms / 1000);
+    app_metrics.last_refresh_ms = delay_ms;
+    return delay_ms;
+}
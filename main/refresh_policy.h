@@ -0,0 +1,19 @@
+#ifndef refresh_policy
+#define refresh_policy
+
+#include "stdint.h"
+#include "stdbool.h"
+
+//Bounds of the delay between two weather fetches
+#define ONE_HOUR_MS (1000 * 60 * 60)
+#define REFRESH_MIN_MS (1000 * 60 * 10)
+#define REFRESH_MAX_MS (ONE_HOUR_MS * 3)
+#define REFRESH_BASE_MS ONE_HOUR_MS
+
+//Backoff after failed fetches
+#define BACKOFF_START_MS (1000 * 30)
+#define BACKOFF_JITTER_PCT 25
+
+uint32_t refresh_next_delay(const float* api_values, bool fetch_ok);
+
+#endif // refresh_policy
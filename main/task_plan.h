@@ -0,0 +1,56 @@
+#ifndef task_plan
+#define task_plan
+
+//Every task of the project, all statically allocated in main.c
+//Stack use is an estimate from each task's deepest call chain (TLS handshake, JSON scan, LVGL calls),
+//not a measured peak. The reserved stack adds STACK_MARGIN on top, stack_report() logs the
+//uxTaskGetStackHighWaterMark peaks after every fetch and warns when a task eats into the margin.
+//1 replaces the three polling tasks with one event loop task (event_loop.c),
+//the fetch still runs on its own task so the loop keeps ticking while the radio is up
+#define EVENT_LOOP_MODE 0
+
+//Network and parse work runs on PRO_CPU next to the Wi-Fi/lwIP tasks,
+//timekeeping and rendering run on APP_CPU at higher priority so TLS and JSON never delay the minute tick
+//X(id, function, name, stack use in bytes, core, priority)
+#if EVENT_LOOP_MODE
+#define TASK_TABLE(X) \
+    X(loop,    event_loop_task, "Event Loop Task",         1536, APP_CPU, 5) \
+    X(fetch,   fetch_task,      "Fetch Task",              6144, PRO_CPU, 2) \
+    X(blog,    blog_drain_task, "Log Drain Task",          1536, PRO_CPU, 1)
+#else
+#define TASK_TABLE(X) \
+    X(time,    update_time,    "Get Time Task",            1536, APP_CPU, 6) \
+    X(weather, update_weather, "Get Weather Task",         6144, PRO_CPU, 2) \
+    X(lvgl,    send_to_lvgl,   "Process Queue Items Task", 1536, APP_CPU, 5) \
+    X(blog,    blog_drain_task, "Log Drain Task",          1536, PRO_CPU, 1)
+#endif
+
+#define PRO_CPU 0
+#define APP_CPU 1
+
+//esp_lvgl_port task, renders and flushes right after the producers hand over
+#define LVGL_PORT_CORE APP_CPU
+#define LVGL_PORT_PRIORITY 4
+
+#define STACK_MARGIN 512
+#define HEAP_DRIFT_MAX 1024 //Wi-Fi and the LVGL port task keep allocating while the tasks are made
+
+//Queue between the producers and the display task, or the event queue of the loop
+#define QUEUE_LEN 5
+#define TIME_ITEM_SIZE 7        //{LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES, SECONDS}
+#define WEATHER_ITEM_SIZE 4     //{LENGTH, TEMPERATURE, PRECIPITATION, WEATHER CODE}
+#define FORECAST_DAYS 3
+#define FORECAST_ITEM_SIZE (1 + FORECAST_DAYS * 3) //{LENGTH, MAX, MIN, CODE, MAX, MIN, CODE, ...}
+#define MAX_ITEM_SIZE FORECAST_ITEM_SIZE
+#if EVENT_LOOP_MODE
+#define QUEUE_ITEM_BYTES (2 * sizeof(void*))
+#else
+#define QUEUE_ITEM_BYTES (sizeof(float) * MAX_ITEM_SIZE)
+#endif
+
+//Total RAM the table reserves, checked against the budget at compile time
+#define TASK_STACK_SUM(id, fn, name, used, core, prio) + (used) + STACK_MARGIN + sizeof(StaticTask_t)
+#define STATIC_RAM_TOTAL (0 TASK_TABLE(TASK_STACK_SUM) + QUEUE_LEN * QUEUE_ITEM_BYTES + sizeof(StaticQueue_t))
+#define STATIC_RAM_BUDGET (1024 * 13) //the TLS handshake takes 3 KB more weather stack than plain HTTP
+
+#endif // task_plan
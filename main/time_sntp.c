@@ -1,11 +1,36 @@
 /*
 This file is used to setup and run the time module
+The display reads its time from the system clock. Every SNTP sync after boot slews the
+system clock with adjtime instead of stepping it, unless the error is too large to slew,
+and the offsets between syncs give the drift of the local oscillator.
 */
 
 #include "esp_log.h"
 #include "esp_sntp.h"
-
-static time_t current_time; 
+#include "time_sntp.h"
+#include "dns_cache.h"
+#include "task_plan.h"
+#include "metrics.h"
+#include "trace.h"
+#include "esp_timer.h"
+#include "sys/time.h"
+#include "stdlib.h"
+
+//Static variables
+static int64_t last_sync_us = 0;      //esp_timer time of the previous sync, 0 before the first one
+static esp_timer_handle_t boundary_timer = NULL;
+
+//Points SNTP at the cached server address, or lets lwIP resolve the name
+static void sntp_set_server(){
+    esp_ip4_addr_t addr;
+    if(dns_cache_lookup(NTP_SERVER, &addr) == ESP_OK){
+        ip_addr_t server = IPADDR4_INIT(addr.addr);
+        esp_sntp_setserver(0, &server);
+    }
+    else{
+        esp_sntp_setservername(0, NTP_SERVER);
+    }
+}
 
 //Initalize sntp and sync current time
 float* sntp_start(){
@@ -14,7 +39,7 @@ float* sntp_start(){
 
     ESP_LOGI("SNTP", "Initializing SNTP...");
     esp_sntp_setoperatingmode(ESP_SNTP_OPMODE_POLL);
-    esp_sntp_setservername(0, "pool.ntp.org");  // Use NTP server
+    sntp_set_server();  // Use NTP server
     esp_sntp_init();
     ESP_LOGI("SNTP", "Initailizing done");
 
@@ -25,24 +50,25 @@ float* sntp_start(){
     }
 
     ESP_LOGI("TIME","Sync done");
+    esp_sntp_stop(); //further syncs only happen inside the network window
 
     time(&now);
     setenv("TZ","EST+5EDT,M3.2.0/2,M11.1.0/2",1); //set time to EST
     tzset();
 
-    current_time = now;
-    localtime_r(&current_time,&timeinfo);
+    localtime_r(&now,&timeinfo);
     // ESP_LOGI("TIME", "Current time: %02d-%02d-%04d %02d:%02d:%02d",
     // timeinfo.tm_mday, timeinfo.tm_mon + 1, timeinfo.tm_year + 1900,
     // timeinfo.tm_hour, timeinfo.tm_min, timeinfo.tm_sec);
 
-    static float timeData[6]; //max item size
-    timeData[0] = 6;
+    static float timeData[TIME_ITEM_SIZE];
+    timeData[0] = TIME_ITEM_SIZE;
     timeData[1] = timeinfo.tm_mday;
     timeData[2] = timeinfo.tm_mon + 1;
     timeData[3] = timeinfo.tm_year + 1900;
     timeData[4] = timeinfo.tm_hour;
     timeData[5] = timeinfo.tm_min;
+    timeData[6] = timeinfo.tm_sec;
     // for(int i = 0; i < 6; ++i){
     //     ESP_LOGI("SNTP","content: %02f",timeData[i]);
     // }
@@ -62,18 +88,109 @@ float* sntp_start(){
     // ESP_LOGI("TIME","Current time in NYC is: %s",time_buf);
 }
 
-//Increments the time by a second every time its called
-//If seconds are reset to 0, one minute has passed and returns the time variable
+//Runs one SNTP exchange and stops again so SNTP never wakes the radio on its own
+esp_err_t sntp_resync(uint32_t timeout_ms){
+    sntp_set_server();
+    esp_sntp_init();
+    uint32_t waited_ms = 0;
+    while(sntp_get_sync_status() != SNTP_SYNC_STATUS_COMPLETED){
+        if(waited_ms >= timeout_ms){
+            esp_sntp_stop();
+            ESP_LOGW("TIME","Resync timed out");
+            return ESP_ERR_TIMEOUT;
+        }
+        vTaskDelay(100 / portTICK_PERIOD_MS);
+        waited_ms += 100;
+    }
+    esp_sntp_stop();
+    ESP_LOGI("TIME","Resync done");
+    return ESP_OK;
+}
+
+//Called by SNTP with the server time, replaces the default that always steps the clock
+void sntp_sync_time(struct timeval *tv){
+    struct timeval local;
+    gettimeofday(&local, NULL);
+    int64_t now_us = esp_timer_get_time();
+    int64_t offset_us = (tv->tv_sec - local.tv_sec) * 1000000LL + (tv->tv_usec - local.tv_usec);
+
+    if(last_sync_us == 0 || llabs(offset_us) > CLOCK_STEP_MS * 1000LL){
+        settimeofday(tv, NULL);
+        if(last_sync_us != 0){
+            app_metrics.clock_steps++;
+            ESP_LOGW("TIME","Clock off by %lld ms, stepped", offset_us / 1000);
+        }
+    }
+    else{
+        //Whatever is still being slewed from the last sync is not drift
+        struct timeval left;
+        adjtime(NULL, &left);
+        int64_t drift_us = offset_us - (left.tv_sec * 1000000LL + left.tv_usec);
+        app_metrics.clock_drift_ppm = drift_us * 1e6f / (now_us - last_sync_us);
+
+        struct timeval delta = {.tv_sec = offset_us / 1000000, .tv_usec = offset_us % 1000000};
+        adjtime(&delta, NULL);
+        ESP_LOGI("TIME","Clock off by %lld ms, slewing, drift %.2f ppm", offset_us / 1000, app_metrics.clock_drift_ppm);
+    }
+
+    if(last_sync_us != 0){
+        app_metrics.clock_offset_ms[app_metrics.clock_syncs % CLOCK_OFFSET_HISTORY] = offset_us / 1000;
+        app_metrics.clock_syncs++;
+    }
+    last_sync_us = now_us;
+    TRACE_MARK(TRACE_SNTP_SYNC, 0);
+    sntp_set_sync_status(SNTP_SYNC_STATUS_COMPLETED);
+}
+
+//True once now is in a later minute than last_minute, which then moves to that minute
+bool clock_new_minute(time_t now, time_t* last_minute){
+    time_t minute = now - now % 60;
+    if(minute == *last_minute){
+        return false;
+    }
+    *last_minute = minute;
+    return true;
+}
+
+//Polled by the event loop, returns the minute once the system clock enters a new one
 time_t* increment_time(){
     static time_t last_minute_time = 0;
 
-    current_time+= 1;
-    struct tm timeinfo;
-    localtime_r(&current_time,&timeinfo);
-
-    if(timeinfo.tm_sec == 0){
-        last_minute_time = current_time;
+    if(clock_new_minute(time(NULL), &last_minute_time)){
         return &last_minute_time;
     }
     return NULL;
 }
+
+static void boundary_cb(void* arg){
+    xTaskNotifyGive((TaskHandle_t)arg);
+}
+
+//Blocks the calling task until the next multiple of period_s on the system clock and returns that time
+//The esp_timer wakes the task with microsecond resolution. A wakeup a little early (slew, timer rounding)
+//leaves the clock just short of the boundary, so the boundary returned last is remembered and never
+//returned twice, while one that is only milliseconds away is still waited for instead of skipped
+time_t clock_wait_boundary(uint32_t period_s){
+    static int64_t last_boundary_us = 0;
+    if(boundary_timer == NULL){
+        const esp_timer_create_args_t timer_args = {
+            .callback = boundary_cb,
+            .arg = xTaskGetCurrentTaskHandle(),
+            .name = "clock",
+        };
+        ESP_ERROR_CHECK(esp_timer_create(&timer_args, &boundary_timer));
+    }
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    int64_t period_us = period_s * 1000000LL;
+    int64_t now_us = tv.tv_sec * 1000000LL + tv.tv_usec;
+    int64_t target_us = (now_us / period_us + 1) * period_us; //first boundary strictly after now
+    if(target_us == last_boundary_us){ //woke before the one just returned, take the next
+        target_us += period_us;
+    }
+    esp_timer_start_once(boundary_timer, target_us - now_us);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    last_boundary_us = target_us;
+    return target_us / 1000000;
+}
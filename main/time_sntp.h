@@ -2,8 +2,15 @@
 #define time_sntp
 
 #include "esp_sntp.h"
+#include "stdbool.h"
+
+#define NTP_SERVER "pool.ntp.org"
+#define CLOCK_STEP_MS 2000 //larger errors are stepped, smaller ones slewed with adjtime
 
 float* sntp_start();
+esp_err_t sntp_resync(uint32_t timeout_ms);
 time_t* increment_time();
+bool clock_new_minute(time_t now, time_t* last_minute);
+time_t clock_wait_boundary(uint32_t period_s);
 
 #endif // time_sntp
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*
+This file fast forwards the display clock through a full year
+Every minute of the year is checked against strftime, with extra checks at midnight and at the DST changes
+It also drives the now page through a fixed list of updates for the golden frame comparison
+*/
+
+#include "stdio.h"
+#include "string.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "task_plan.h"
+#include "time_sntp.h"
+#include "i2c_oled.h"
+#include "digit_clock.h"
+#include "page_cache.h"
+#include "timewarp.h"
+
+#define LABEL_LEN 16
+#define MAX_REPORTED 8 //failures logged in full, the rest are only counted
+#if CLOCK_SECONDS
+#define CLOCK_STRFTIME "%H:%M:%S"
+#define CLOCK_MIDNIGHT "00:00:00"
+#else
+#define CLOCK_STRFTIME "%I:%M%p"
+#define CLOCK_MIDNIGHT "12:00AM"
+#endif
+
+//Static variables
+static uint32_t failures = 0;
+
+#if CAPTURE_FRAMES
+//Each frame is the now page after its update on top of all the ones before, the name is the golden file
+typedef struct {
+    const char* name;
+    float data[MAX_ITEM_SIZE];
+} FrameCase;
+
+static const FrameCase frame_cases[] = {
+    {"midnight",      {TIME_ITEM_SIZE, 1, 1, 2025, 0, 0, 0}},
+    {"clear",         {WEATHER_ITEM_SIZE, 72, 0, 0}},
+    {"before_noon",   {TIME_ITEM_SIZE, 30, 6, 2025, 11, 59, 0}},
+    {"noon",          {TIME_ITEM_SIZE, 30, 6, 2025, 12, 0, 0}},
+    {"year_end",      {TIME_ITEM_SIZE, 31, 12, 2025, 23, 59, 0}},
+    {"cloudy",        {WEATHER_ITEM_SIZE, 55, 0.01, 3}},
+    {"drizzle",       {WEATHER_ITEM_SIZE, 48, 0.12, 51}},
+    {"rain",          {WEATHER_ITEM_SIZE, 61, 1.25, 63}},
+    {"snow_negative", {WEATHER_ITEM_SIZE, -4, 0.4, 73}},
+    {"cold_two_digit", {WEATHER_ITEM_SIZE, -23, 0, 86}},
+    {"storm_long",    {WEATHER_ITEM_SIZE, 104, 12.34, 99}},
+    {"unknown_code",  {WEATHER_ITEM_SIZE, 65, 0, 58}}, //keeps the previous symbol and name
+};
+#endif
+
+//Same layout as the queue item, {LENGTH, DAY, MONTH, YEAR, HOUR, MINUTES, SECONDS}
+static void warp_time_data(const struct tm *timeinfo, float* data){
+    data[0] = TIME_ITEM_SIZE;
+    data[1] = timeinfo->tm_mday;
+    data[2] = timeinfo->tm_mon + 1;
+    data[3] = timeinfo->tm_year + 1900;
+    data[4] = timeinfo->tm_hour;
+    data[5] = timeinfo->tm_min;
+    data[6] = timeinfo->tm_sec;
+}
+
+static void warp_fail(time_t t, const char* what, const char* got, const char* want){
+    if(failures < MAX_REPORTED){
+        ESP_LOGE("WARP", "%lld: %s, got '%s' want '%s'", (long long)t, what, got, want);
+    }
+    failures++;
+}
+
+//Returns the number of failed checks, 0 when the whole year matched
+uint32_t timewarp_run(){
+    int64_t start_us = esp_timer_get_time();
+    failures = 0;
+
+    //Start at local midnight on January 1st of this year
+    time_t now = time(NULL);
+    struct tm start;
+    localtime_r(&now, &start);
+    start.tm_mon = 0;
+    start.tm_mday = 1;
+    start.tm_hour = 0;
+    start.tm_min = 0;
+    start.tm_sec = 0;
+    start.tm_isdst = -1;
+    time_t t = mktime(&start);
+    start.tm_year++; //up to next January 1st, so leap years get their December 31st
+    start.tm_isdst = -1;
+    time_t end = mktime(&start);
+
+    float data[TIME_ITEM_SIZE];
+    char got[LABEL_LEN];
+    char want[LABEL_LEN];
+    char last_date[LABEL_LEN] = "";
+    struct tm prev = {0};
+    bool have_prev = false;
+    uint8_t dst_changes = 0;
+
+    for(; t < end; t += 60){
+        //The second before the minute must not report one, the minute itself must
+        time_t last_minute = t - 60;
+        if(clock_new_minute(t - 1, &last_minute) || !clock_new_minute(t, &last_minute) || last_minute != t){
+            warp_fail(t, "minute tick", "", "");
+        }
+
+        struct tm timeinfo;
+        localtime_r(&t, &timeinfo);
+        warp_time_data(&timeinfo, data);
+
+        format_time_label(data, got, sizeof(got));
+        strftime(want, sizeof(want), CLOCK_STRFTIME, &timeinfo);
+        if(strcmp(got, want) != 0){
+            warp_fail(t, "time label", got, want);
+        }
+
+        format_date_label(data, got, sizeof(got));
+        strftime(want, sizeof(want), "%m/%d/%y", &timeinfo);
+        if(strcmp(got, want) != 0){
+            warp_fail(t, "date label", got, want);
+        }
+
+        //Midnight rollover, the date changes exactly when the clock shows 12:00AM
+        bool midnight = timeinfo.tm_hour == 0 && timeinfo.tm_min == 0;
+        if(have_prev && midnight != (strcmp(got, last_date) != 0)){
+            warp_fail(t, "date rollover", got, last_date);
+        }
+        strlcpy(last_date, got, sizeof(last_date));
+        if(midnight){
+            format_time_label(data, got, sizeof(got));
+            if(strcmp(got, CLOCK_MIDNIGHT) != 0){
+                warp_fail(t, "midnight label", got, CLOCK_MIDNIGHT);
+            }
+        }
+
+        //Wall clock moves one minute, except at 2AM on the DST days where it skips or repeats an hour
+        if(have_prev){
+            int prev_min = prev.tm_hour * 60 + prev.tm_min;
+            int cur_min = timeinfo.tm_hour * 60 + timeinfo.tm_min;
+            int step = (cur_min - prev_min + 24 * 60) % (24 * 60);
+            if(timeinfo.tm_isdst != prev.tm_isdst){
+                dst_changes++;
+                int want_step = timeinfo.tm_isdst ? 61 : 24 * 60 - 59;
+                if(step != want_step){
+                    snprintf(got, sizeof(got), "%d", step);
+                    snprintf(want, sizeof(want), "%d", want_step);
+                    warp_fail(t, "DST step", got, want);
+                }
+                ESP_LOGI("WARP", "DST %s at %02d:%02d -> %02d:%02d", timeinfo.tm_isdst ? "starts" : "ends",
+                    prev.tm_hour, prev.tm_min, timeinfo.tm_hour, timeinfo.tm_min);
+            }
+            else if(step != 1){
+                snprintf(got, sizeof(got), "%d", step);
+                warp_fail(t, "minute step", got, "1");
+            }
+        }
+        prev = timeinfo;
+        have_prev = true;
+
+        if(timeinfo.tm_hour == 0 && timeinfo.tm_min == 0){
+            vTaskDelay(1); //one day done, let the idle task feed the watchdog
+        }
+    }
+
+    if(dst_changes != TIMEWARP_DST_CHANGES){
+        snprintf(got, sizeof(got), "%d", dst_changes);
+        snprintf(want, sizeof(want), "%d", TIMEWARP_DST_CHANGES);
+        warp_fail(end, "DST changes", got, want);
+    }
+
+    ESP_LOGI("WARP", "Year replayed in %lld ms, %lu failed checks",
+        (esp_timer_get_time() - start_us) / 1000, failures);
+    return failures;
+}
+
+#if CAPTURE_FRAMES
+//Applies every frame case and prints the now page after each, always the same frames in the same order
+void timewarp_frames(){
+    float data[MAX_ITEM_SIZE];
+    for(size_t i = 0; i < sizeof(frame_cases) / sizeof(frame_cases[0]); ++i){
+        memcpy(data, frame_cases[i].data, sizeof(data)); //lvgl_update takes a writable item
+        lvgl_update(data);
+        lvgl_capture(frame_cases[i].name);
+    }
+    ESP_LOGI("WARP", "%u frames captured", sizeof(frame_cases) / sizeof(frame_cases[0]));
+}
+#endif
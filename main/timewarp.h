@@ -0,0 +1,20 @@
+#ifndef timewarp
+#define timewarp
+
+#include "time.h"
+#include "stdint.h"
+
+//1 runs the clock and label code through a whole year at boot, minute by minute, before any task starts
+//Only the date and time formatters and the minute tick are covered, refresh_policy, clock_wait_boundary
+//and the SNTP slew run on the real clock and are not exercised by it
+#define TIMEWARP_SELFTEST 0
+#define TIMEWARP_DST_CHANGES 2 //transitions expected in one year of the TZ set by sntp_start
+
+//1 prints every HTTP body as a "REC <unix time> HTTP ..." line, tools/mock_server.py --replay
+//serves the recorded bodies again in the same order, one per request
+#define RECORD_SESSION 0
+
+uint32_t timewarp_run();
+void timewarp_frames();
+
+#endif // timewarp
@@ -0,0 +1,495 @@
+/*
+This file fetches the weather over HTTPS with mbedTLS
+The CA is pinned to tls_ca.h, and the session of the last handshake with each server is
+offered on every connect and kept in NVS, so most fetches skip the certificate exchange
+Sockets are non-blocking, tls_wait selects on all open connections and steps the ready ones
+*/
+
+#include "tls_fetch.h"
+#include "tls_ca.h"
+#include "metrics.h"
+#include "trace.h"
+#include "string.h"
+#include "strings.h"
+#include "stdio.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "nvs_flash.h"
+#include "errno.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/ctr_drbg.h"
+
+
+#define TLS_SESSION_NS "tls_session"
+
+//Static variables
+static mbedtls_entropy_context entropy;
+static mbedtls_ctr_drbg_context ctr_drbg;
+static mbedtls_x509_crt ca_chain;
+static mbedtls_ssl_config conf;
+static bool ready = false;
+
+static mbedtls_ssl_session session[TLS_SESSION_SLOTS];
+static bool session_valid[TLS_SESSION_SLOTS];
+static uint8_t session_blob[TLS_SESSION_SLOTS][TLS_SESSION_MAX]; //what NVS holds, compared before writing
+static size_t session_blob_len[TLS_SESSION_SLOTS];
+
+//Heap is watched from the first tls_start to the last tls_close, both connections count
+//The low point comes from the heap's own minimum tracking, so the peak inside a handshake step is seen too
+static int active = 0;
+static size_t heap_before = 0;
+
+enum { CHUNK_SIZE, CHUNK_EXT, CHUNK_DATA, CHUNK_DATA_END, CHUNK_DONE };
+
+//Decrypted bytes are handed on before the next read, so every connection shares it
+static char rx[512];
+
+//Called for each certificate of the chain, a resumed handshake never gets here
+static int verify_cb(void *arg, mbedtls_x509_crt *crt, int depth, uint32_t *flags){
+    ((TlsConn *)arg)->full_handshake = true;
+    return 0; //flags are left for mbedTLS to fail on
+}
+
+//Socket reads, counted so the metrics show what came over the air, TLS records and headers included
+static int net_recv_counted(void *ctx, unsigned char *buf, size_t len){
+    int ret = mbedtls_net_recv(ctx, buf, len);
+    if(ret > 0){
+        app_metrics.fetch_wire_bytes += ret;
+    }
+    return ret;
+}
+
+static void session_key(uint8_t slot, char* key, size_t len){
+    snprintf(key, len, "last%u", slot);
+}
+
+static void session_load(){
+#if TLS_SESSION_PERSIST
+    nvs_handle_t nvs;
+    if(nvs_open(TLS_SESSION_NS, NVS_READONLY, &nvs) != ESP_OK){
+        return;
+    }
+    for(uint8_t slot = 0; slot < TLS_SESSION_SLOTS; ++slot){
+        char key[8];
+        size_t len = sizeof(session_blob[slot]);
+        session_key(slot, key, sizeof(key));
+        if(nvs_get_blob(nvs, key, session_blob[slot], &len) == ESP_OK &&
+           mbedtls_ssl_session_load(&session[slot], session_blob[slot], len) == 0){
+            session_blob_len[slot] = len;
+            session_valid[slot] = true;
+            ESP_LOGI("TLS", "Loaded saved session %u, %u bytes", slot, len);
+        }
+    }
+    nvs_close(nvs);
+#endif
+}
+
+//Keeps the session of the handshake that just finished, NVS is only written when it changed
+//A resumed session ID comes back unchanged, a new ticket does not
+static void session_store(uint8_t slot, mbedtls_ssl_context *ssl){
+    static uint8_t blob[TLS_SESSION_MAX]; //only the fetching task gets here, kept off its stack
+    size_t len = 0;
+    mbedtls_ssl_session_free(&session[slot]);
+    mbedtls_ssl_session_init(&session[slot]);
+    session_valid[slot] = mbedtls_ssl_get_session(ssl, &session[slot]) == 0;
+    if(!session_valid[slot]){
+        return;
+    }
+    int ret = mbedtls_ssl_session_save(&session[slot], blob, sizeof(blob), &len);
+    if(ret != 0){ //still resumed from RAM, only NVS misses it
+        ESP_LOGW("TLS", "Session %u not saved (-0x%x), needs %u of %d bytes", slot, -ret, len, TLS_SESSION_MAX);
+        return;
+    }
+    if(len == session_blob_len[slot] && memcmp(blob, session_blob[slot], len) == 0){
+        return;
+    }
+    memcpy(session_blob[slot], blob, len);
+    session_blob_len[slot] = len;
+#if TLS_SESSION_PERSIST
+    nvs_handle_t nvs;
+    char key[8];
+    session_key(slot, key, sizeof(key));
+    if(nvs_open(TLS_SESSION_NS, NVS_READWRITE, &nvs) == ESP_OK){
+        nvs_set_blob(nvs, key, session_blob[slot], session_blob_len[slot]);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+#endif
+}
+
+//Drops the session after a failed handshake so the next try starts clean
+static void session_forget(uint8_t slot){
+    mbedtls_ssl_session_free(&session[slot]);
+    mbedtls_ssl_session_init(&session[slot]);
+    session_valid[slot] = false;
+}
+
+//Parses the CA and sets up the config shared by every connection, once
+static esp_err_t tls_init(){
+    if(ready){
+        return ESP_OK;
+    }
+    mbedtls_entropy_init(&entropy);
+    mbedtls_ctr_drbg_init(&ctr_drbg);
+    mbedtls_x509_crt_init(&ca_chain);
+    mbedtls_ssl_config_init(&conf);
+    for(int slot = 0; slot < TLS_SESSION_SLOTS; ++slot){
+        mbedtls_ssl_session_init(&session[slot]);
+    }
+
+    if(mbedtls_ctr_drbg_seed(&ctr_drbg, mbedtls_entropy_func, &entropy, NULL, 0) != 0 ||
+       mbedtls_x509_crt_parse(&ca_chain, (const uint8_t *)tls_ca_pem, sizeof(tls_ca_pem)) != 0 ||
+       mbedtls_ssl_config_defaults(&conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT) != 0){
+        ESP_LOGE("TLS", "Setup failed");
+        return ESP_FAIL;
+    }
+    mbedtls_ssl_conf_authmode(&conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_ca_chain(&conf, &ca_chain, NULL);
+    mbedtls_ssl_conf_rng(&conf, mbedtls_ctr_drbg_random, &ctr_drbg);
+    mbedtls_ssl_conf_max_tls_version(&conf, MBEDTLS_SSL_VERSION_TLS1_2); //1.3 tickets only arrive after the first read
+    mbedtls_ssl_conf_session_tickets(&conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+#if defined(MBEDTLS_SSL_MAX_FRAGMENT_LENGTH)
+    mbedtls_ssl_conf_max_frag_len(&conf, MBEDTLS_SSL_MAX_FRAG_LEN_4096); //servers that honour it keep the dynamic in buffer small
+#endif
+    session_load();
+    ready = true;
+    return ESP_OK;
+}
+
+static bool finish(TlsConn* conn, TlsState state){
+    conn->state = state;
+    conn->end_us = esp_timer_get_time();
+    return true;
+}
+
+static bool fail(TlsConn* conn, int ret){
+    app_metrics.tls_failures++;
+    ESP_LOGW("TLS", "Fetch %u failed: -0x%x", conn->slot, -ret);
+    return finish(conn, TLS_FAILED);
+}
+
+//True if the response headers have a line "name: ...value..." (name case insensitive)
+static bool header_has(const TlsConn* conn, const char* name, const char* value){
+    size_t len = strlen(name);
+    for(const char* line = strstr(conn->header, "\r\n"); line != NULL; line = strstr(line + 2, "\r\n")){
+        if(strncasecmp(line + 2, name, len) == 0 && line[2 + len] == ':'){
+            const char* eol = strstr(line + 2, "\r\n");
+            const char* found = strstr(line + 2 + len, value);
+            return found != NULL && (eol == NULL || found < eol);
+        }
+    }
+    return false;
+}
+
+static int hex_value(char c){
+    if(c >= '0' && c <= '9'){
+        return c - '0';
+    }
+    if((c | 0x20) >= 'a' && (c | 0x20) <= 'f'){
+        return (c | 0x20) - 'a' + 10;
+    }
+    return -1;
+}
+
+//Passes body bytes on, taking the chunk framing off first when there is one
+static void body_bytes(TlsConn* conn, const char* data, int len){
+    if(!conn->chunked){
+        conn->sink(conn->arg, data, len);
+        return;
+    }
+    while(len > 0 && conn->chunk_state != CHUNK_DONE){ //trailers after the last chunk are dropped
+        char c = *data;
+        switch(conn->chunk_state){
+        case CHUNK_SIZE: //hex size, then optional ;extensions, then CRLF
+            if(hex_value(c) >= 0){
+                conn->chunk_left = conn->chunk_left * 16 + hex_value(c);
+            }
+            else{
+                conn->chunk_state = CHUNK_EXT;
+            }
+            // fall through
+        case CHUNK_EXT:
+            if(c == '\n'){
+                conn->chunk_state = conn->chunk_left > 0 ? CHUNK_DATA : CHUNK_DONE;
+            }
+            data++;
+            len--;
+            break;
+        case CHUNK_DATA: {
+            int n = (uint32_t)len < conn->chunk_left ? len : (int)conn->chunk_left;
+            conn->sink(conn->arg, data, n);
+            data += n;
+            len -= n;
+            conn->chunk_left -= n;
+            if(conn->chunk_left == 0){
+                conn->chunk_state = CHUNK_DATA_END;
+            }
+            break;
+        }
+        case CHUNK_DATA_END: //CRLF after the data
+            if(c == '\n'){
+                conn->chunk_state = CHUNK_SIZE;
+            }
+            data++;
+            len--;
+            break;
+        }
+    }
+}
+
+//Collects the status line and headers, returns where the body starts in rx
+//-1 while they are incomplete, -2 when they are not HTTP or do not fit
+static int read_headers(TlsConn* conn, int len){
+    int copy = len < TLS_HEADER_MAX - 1 - conn->header_len ? len : TLS_HEADER_MAX - 1 - conn->header_len;
+    memcpy(conn->header + conn->header_len, rx, copy);
+    conn->header_len += copy;
+    conn->header[conn->header_len] = '\0';
+    char *end = strstr(conn->header, "\r\n\r\n");
+    if(end == NULL){
+        if(conn->header_len == TLS_HEADER_MAX - 1){
+            ESP_LOGW("TLS", "Headers over %d bytes", TLS_HEADER_MAX);
+            return -2;
+        }
+        return -1;
+    }
+    if(sscanf(conn->header, "HTTP/%*d.%*d %d", &conn->status) != 1){
+        conn->status = 0;
+        return -2;
+    }
+    end[2] = '\0'; //keep the last CRLF for header_has
+    conn->chunked = header_has(conn, "Transfer-Encoding", "chunked");
+    conn->chunk_state = CHUNK_SIZE;
+    conn->chunk_left = 0;
+    return (end + 4 - conn->header) - (conn->header_len - copy);
+}
+
+//Reads until mbedTLS runs dry, the body ends when the server closes or with the last chunk
+static bool receive(TlsConn* conn){
+    while(1){
+        int ret = mbedtls_ssl_read(&conn->ssl, (uint8_t *)rx, sizeof(rx));
+        if(ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE){
+            conn->want_write = ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+            return false;
+        }
+        if(ret == 0 || ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY || ret == MBEDTLS_ERR_SSL_CONN_EOF){ //many servers skip close_notify
+            return conn->status != 0 && !conn->chunked ? finish(conn, TLS_DONE) : fail(conn, MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
+        }
+        if(ret < 0){
+            return fail(conn, ret);
+        }
+        int body_ofs = 0;
+        if(conn->status == 0){
+            body_ofs = read_headers(conn, ret);
+            if(body_ofs == -2){
+                return fail(conn, MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
+            }
+        }
+        if(body_ofs >= 0 && body_ofs < ret){
+            body_bytes(conn, rx + body_ofs, ret - body_ofs);
+        }
+        if(conn->chunked && conn->chunk_state == CHUNK_DONE){ //no need to wait for the close
+            return finish(conn, TLS_DONE);
+        }
+    }
+}
+
+//Moves conn on as far as it goes without blocking, true once it is DONE or FAILED
+//Only called when select says the socket is ready for what the connection waits on
+static bool step(TlsConn* conn){
+    int ret;
+    switch(conn->state){
+    case TLS_CONNECTING: {
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if(getsockopt(conn->net.fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0){
+            return fail(conn, MBEDTLS_ERR_NET_CONNECT_FAILED);
+        }
+        conn->state = TLS_HANDSHAKE;
+        conn->handshake_us = esp_timer_get_time();
+        TRACE_BEGIN(TRACE_TLS_HANDSHAKE, session_valid[conn->slot]);
+    }
+        // fall through
+    case TLS_HANDSHAKE: {
+        ret = mbedtls_ssl_handshake(&conn->ssl);
+        if(ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE){
+            conn->want_write = ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+            return false;
+        }
+        TRACE_END(TRACE_TLS_HANDSHAKE, conn->full_handshake);
+        if(ret != 0){
+            uint32_t flags = mbedtls_ssl_get_verify_result(&conn->ssl);
+            if(flags != 0){
+                ESP_LOGW("TLS", "Certificate rejected, flags 0x%lx", flags);
+            }
+            session_forget(conn->slot);
+            return fail(conn, ret);
+        }
+        uint32_t handshake_ms = (esp_timer_get_time() - conn->handshake_us) / 1000;
+        app_metrics.tls_handshakes++;
+        if(conn->full_handshake){
+            app_metrics.tls_full_ms = handshake_ms;
+        }
+        else{
+            app_metrics.tls_resumed++;
+            app_metrics.tls_resumed_ms = handshake_ms;
+        }
+        session_store(conn->slot, &conn->ssl);
+        conn->state = TLS_SENDING;
+    }
+        // fall through
+    case TLS_SENDING:
+        while(conn->sent < conn->request_len){
+            ret = mbedtls_ssl_write(&conn->ssl, (const uint8_t *)conn->request + conn->sent, conn->request_len - conn->sent);
+            if(ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE){
+                conn->want_write = ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+                return false;
+            }
+            if(ret < 0){
+                return fail(conn, ret);
+            }
+            conn->sent += ret;
+        }
+        conn->state = TLS_RECEIVING;
+        // fall through
+    case TLS_RECEIVING:
+        return receive(conn);
+    default:
+        return false;
+    }
+}
+
+//Opens a non-blocking connection to addr:port for GET path, the certificate is checked against host
+//addr should be an IP, a host name is resolved here and blocks every other connection meanwhile
+//slot picks the saved session, headers are extra request lines each ending in \r\n
+//conn must be given to tls_close afterwards, even when this fails
+esp_err_t tls_start(TlsConn* conn, uint8_t slot, const char* addr, const char* port, const char* host, const char* path,
+const char* headers, TlsBodySink sink, void* arg){
+    mbedtls_net_init(&conn->net);
+    mbedtls_ssl_init(&conn->ssl);
+    conn->state = TLS_CONNECTING;
+    conn->slot = slot;
+    conn->status = 0;
+    conn->io_us = esp_timer_get_time();
+    conn->want_write = false;
+    conn->full_handshake = false;
+    conn->sink = sink;
+    conn->arg = arg;
+    conn->sent = 0;
+    conn->header_len = 0;
+    conn->chunked = false;
+    if(active++ == 0){
+        heap_before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+        heap_caps_monitor_local_minimum_free_size_start(); //minimum free size now counts from here
+    }
+    if(tls_init() != ESP_OK){
+        fail(conn, MBEDTLS_ERR_SSL_BAD_CONFIG);
+        return ESP_FAIL;
+    }
+
+    //One request per connection, the server closes after the response
+    conn->request_len = snprintf(conn->request, sizeof(conn->request),
+    "GET %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: esp32-weather\r\nConnection: close\r\n%s\r\n", path, host, headers);
+    if(conn->request_len >= (int)sizeof(conn->request)){
+        fail(conn, MBEDTLS_ERR_SSL_BAD_INPUT_DATA);
+        return ESP_FAIL;
+    }
+
+    //mbedtls_net_connect blocks until connected, so the socket is opened here
+    struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM, .ai_protocol = IPPROTO_TCP };
+    struct addrinfo *res = NULL;
+    if(getaddrinfo(addr, port, &hints, &res) != 0 || res == NULL){
+        fail(conn, MBEDTLS_ERR_NET_UNKNOWN_HOST);
+        return ESP_FAIL;
+    }
+    conn->net.fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    int ret = conn->net.fd < 0 ? -1 : mbedtls_net_set_nonblock(&conn->net);
+    if(ret == 0){
+        ret = connect(conn->net.fd, res->ai_addr, res->ai_addrlen);
+    }
+    freeaddrinfo(res);
+    if(ret != 0 && errno != EINPROGRESS){
+        fail(conn, MBEDTLS_ERR_NET_CONNECT_FAILED);
+        return ESP_FAIL;
+    }
+
+    if((ret = mbedtls_ssl_setup(&conn->ssl, &conf)) != 0 ||
+       (ret = mbedtls_ssl_set_hostname(&conn->ssl, host)) != 0){ //SNI, and the name the certificate must carry
+        fail(conn, ret);
+        return ESP_FAIL;
+    }
+    mbedtls_ssl_set_bio(&conn->ssl, &conn->net, mbedtls_net_send, net_recv_counted, NULL);
+    mbedtls_ssl_set_verify(&conn->ssl, verify_cb, conn);
+    if(session_valid[slot]){
+        mbedtls_ssl_set_session(&conn->ssl, &session[slot]);
+    }
+    return ESP_OK;
+}
+
+//Waits up to timeout_ms for any open connection to be ready and steps the ready ones
+//Returns true when one of them got DONE or FAILED, connections without progress for TLS_TIMEOUT_MS fail
+bool tls_wait(TlsConn* conns, int count, uint32_t timeout_ms){
+    bool finished = false;
+    int max_fd = -1;
+    fd_set rd, wr;
+    FD_ZERO(&rd);
+    FD_ZERO(&wr);
+    int64_t now = esp_timer_get_time();
+    for(int i = 0; i < count; ++i){
+        TlsConn* conn = &conns[i];
+        if(conn->state == TLS_IDLE || conn->state == TLS_DONE || conn->state == TLS_FAILED){
+            continue;
+        }
+        int64_t idle_ms = (now - conn->io_us) / 1000;
+        if(idle_ms >= TLS_TIMEOUT_MS){
+            finished |= fail(conn, MBEDTLS_ERR_SSL_TIMEOUT);
+            continue;
+        }
+        if(TLS_TIMEOUT_MS - idle_ms < timeout_ms){ //wake up in time to give up on it
+            timeout_ms = TLS_TIMEOUT_MS - idle_ms;
+        }
+        FD_SET(conn->net.fd, conn->state == TLS_CONNECTING || conn->want_write ? &wr : &rd);
+        if(conn->net.fd > max_fd){
+            max_fd = conn->net.fd;
+        }
+    }
+    if(finished || max_fd < 0){
+        return finished;
+    }
+
+    struct timeval tv = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+    if(select(max_fd + 1, &rd, &wr, NULL, &tv) <= 0){
+        return false;
+    }
+    for(int i = 0; i < count; ++i){
+        TlsConn* conn = &conns[i];
+        if(conn->state != TLS_IDLE && conn->state != TLS_DONE && conn->state != TLS_FAILED &&
+           (FD_ISSET(conn->net.fd, &rd) || FD_ISSET(conn->net.fd, &wr))){
+            conn->io_us = esp_timer_get_time();
+            finished |= step(conn);
+        }
+    }
+    return finished;
+}
+
+//Closes the connection whatever state it is in, an unfinished one is dropped without counting as a failure
+void tls_close(TlsConn* conn){
+    if(conn->state == TLS_IDLE){
+        return;
+    }
+    if(conn->state == TLS_RECEIVING || conn->state == TLS_DONE){
+        mbedtls_ssl_close_notify(&conn->ssl); //one try, the socket is not waited on
+    }
+    mbedtls_ssl_free(&conn->ssl);
+    mbedtls_net_free(&conn->net);
+    conn->state = TLS_IDLE;
+    if(--active == 0){
+        size_t heap_low = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+        heap_caps_monitor_local_minimum_free_size_stop();
+        if(heap_low < heap_before && heap_before - heap_low > app_metrics.tls_heap_peak){
+            app_metrics.tls_heap_peak = heap_before - heap_low;
+        }
+    }
+}
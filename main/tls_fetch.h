@@ -0,0 +1,58 @@
+#ifndef tls_fetch
+#define tls_fetch
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "esp_err.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/net_sockets.h"
+
+//HTTPS GET on mbedTLS directly, esp_http_client cannot hand out the TLS session to keep it
+//Connections are non-blocking so one task can drive a request and its hedge side by side
+//1 keeps the sessions in NVS as well, so the first fetch after a reboot resumes too
+#define TLS_SESSION_PERSIST 1
+#define TLS_SESSION_SLOTS 2     //one saved session per server, the slot is given to tls_start
+#define TLS_SESSION_MAX 512     //serialized session with a ticket, the peer certificate is only kept as a digest
+#define TLS_TIMEOUT_MS 5000     //without progress, handshake included
+#define TLS_HEADER_MAX 512      //status line and headers, the body is streamed past them
+#define TLS_REQUEST_MAX 512
+
+//Gets the decrypted body as it arrives, in pieces of any size
+typedef void (*TlsBodySink)(void* arg, const char* data, int len);
+
+typedef enum {
+    TLS_IDLE,       //not started or closed
+    TLS_CONNECTING,
+    TLS_HANDSHAKE,
+    TLS_SENDING,
+    TLS_RECEIVING,
+    TLS_DONE,       //complete response, status holds the HTTP status
+    TLS_FAILED,
+} TlsState;
+
+typedef struct {
+    TlsState state;
+    uint8_t slot;
+    int status;              //0 until the status line arrived
+    int64_t handshake_us, end_us, io_us; //end_us once DONE or FAILED, io_us at the last progress
+    mbedtls_net_context net;
+    mbedtls_ssl_context ssl;
+    bool want_write;         //what mbedTLS is blocked on
+    bool full_handshake;     //certificates were checked, the session was not resumed
+    TlsBodySink sink;
+    void* arg;
+    char request[TLS_REQUEST_MAX];
+    int request_len, sent;
+    char header[TLS_HEADER_MAX];
+    int header_len;
+    bool chunked;            //Transfer-Encoding: chunked, the framing is taken off before the sink
+    uint8_t chunk_state;
+    uint32_t chunk_left;
+} TlsConn;
+
+esp_err_t tls_start(TlsConn* conn, uint8_t slot, const char* addr, const char* port, const char* host, const char* path,
+const char* headers, TlsBodySink sink, void* arg);
+bool tls_wait(TlsConn* conns, int count, uint32_t timeout_ms);
+void tls_close(TlsConn* conn);
+
+#endif // tls_fetch
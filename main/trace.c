@@ -0,0 +1,113 @@
+/*
+This file records the pipeline trace and prints it in the Chrome trace event format
+An event is 12 bytes: timestamp, task, stage, phase and one argument (item length, page, status).
+Any task can add events, a slot is claimed with one atomic add so there is no lock on the hot path.
+The task is an index into a small registry holding a copy of its name, a handle would dangle once
+the task is deleted (app_main ends with vTaskDelete) and could not be named when the ring is printed.
+The dump is formatted into one buffer and written with a single fwrite, so log lines from other
+tasks cannot land in the middle of the JSON.
+*/
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "stdbool.h"
+#include "string.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "trace.h"
+
+#define TRACE_LINE_MAX 128 //longest event or thread name line of the dump
+#define TRACE_JSON_SIZE ((TRACE_EVENTS + TRACE_TASKS + 1) * TRACE_LINE_MAX + 64)
+
+typedef struct {
+    uint32_t ts_us;
+    uint8_t task;   //index into tasks, TRACE_TASKS when the registry was full
+    uint8_t stage;
+    char phase;
+    uint16_t arg;
+} TraceEvent;
+
+//Static variables
+static TraceEvent events[TRACE_EVENTS];
+static uint32_t head = 0;
+static struct {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+} tasks[TRACE_TASKS];
+static uint32_t task_count = 0;
+static bool paused = false;
+
+#define TRACE_NAME(id, name) name,
+static const char *stage_names[TRACE_STAGE_COUNT] = {TRACE_STAGES(TRACE_NAME)};
+#undef TRACE_NAME
+
+//Registry index of the calling task, registered on its first event
+//The name is compared too, a new task may get the handle of a deleted one
+static uint8_t task_index(){
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    const char *name = pcTaskGetName(NULL);
+    uint32_t count = __atomic_load_n(&task_count, __ATOMIC_ACQUIRE);
+    for(uint32_t i = 0; i < count && i < TRACE_TASKS; ++i){
+        if(tasks[i].handle == self && strncmp(tasks[i].name, name, sizeof(tasks[i].name)) == 0){
+            return i;
+        }
+    }
+    uint32_t index = __atomic_fetch_add(&task_count, 1, __ATOMIC_ACQ_REL);
+    if(index >= TRACE_TASKS){
+        return TRACE_TASKS;
+    }
+    strlcpy(tasks[index].name, name, sizeof(tasks[index].name));
+    __atomic_store_n(&tasks[index].handle, self, __ATOMIC_RELEASE); //last, so no other task matches it half written
+    return index;
+}
+
+void trace_event(TraceStage stage, char phase, uint16_t arg){
+    if(__atomic_load_n(&paused, __ATOMIC_ACQUIRE)){
+        return;
+    }
+    uint32_t index = __atomic_fetch_add(&head, 1, __ATOMIC_RELAXED);
+    TraceEvent *event = &events[index % TRACE_EVENTS];
+    event->ts_us = esp_timer_get_time();
+    event->task = task_index();
+    event->stage = stage;
+    event->phase = phase;
+    event->arg = arg;
+}
+
+//Prints the ring oldest first as {"traceEvents": [...]}, one event per line
+//Tasks become threads named after the task, the core they ran on is not recorded
+//The buffer only exists while the dump runs, it is too big to keep for a debug feature
+void trace_dump_json(){
+    char *json = malloc(TRACE_JSON_SIZE);
+    if(json == NULL){
+        ESP_LOGW("TRACE", "No memory for the %d byte dump", TRACE_JSON_SIZE);
+        return;
+    }
+    __atomic_store_n(&paused, true, __ATOMIC_RELEASE);
+    uint32_t end = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+    uint32_t start = end > TRACE_EVENTS ? end - TRACE_EVENTS : 0;
+    uint32_t named = __atomic_load_n(&task_count, __ATOMIC_ACQUIRE);
+    size_t len = 0;
+
+    len += snprintf(json + len, TRACE_JSON_SIZE - len, "TRACE BEGIN\n{\"traceEvents\": [\n");
+    for(uint32_t t = 0; start < end && t <= TRACE_TASKS && t < named; ++t){ //metadata events naming the threads
+        len += snprintf(json + len, TRACE_JSON_SIZE - len,
+            "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %lu, \"args\": {\"name\": \"%s\"}},\n",
+            t, t < TRACE_TASKS ? tasks[t].name : "other");
+    }
+    for(uint32_t i = start; i < end; ++i){
+        const TraceEvent *event = &events[i % TRACE_EVENTS];
+        len += snprintf(json + len, TRACE_JSON_SIZE - len,
+            "{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %lu, \"pid\": 0, \"tid\": %u, %s\"args\": {\"arg\": %u}}%s\n",
+            stage_names[event->stage], event->phase, event->ts_us, event->task,
+            event->phase == 'i' ? "\"s\": \"t\", " : "", event->arg, i + 1 < end ? "," : "");
+    }
+    len += snprintf(json + len, TRACE_JSON_SIZE - len, "]}\nTRACE END\n");
+    __atomic_store_n(&paused, false, __ATOMIC_RELEASE);
+
+    fwrite(json, 1, len, stdout); //one call holds the stdout lock for the whole dump
+    fflush(stdout);
+    free(json);
+}
@@ -0,0 +1,46 @@
+#ifndef trace
+#define trace
+
+#include "stdint.h"
+
+//1 timestamps every pipeline stage into a ring and prints it as Chrome trace JSON after each fetch
+//Load the part between TRACE BEGIN and TRACE END in chrome://tracing or ui.perfetto.dev, see tools/trace_capture.py
+#define TRACE_ENABLE 0
+#define TRACE_EVENTS 256 //newest events kept
+#define TRACE_TASKS 16   //tasks named in the output, later ones share one "other" thread
+
+//X(id, name shown in the viewer)
+#define TRACE_STAGES(X) \
+    X(TRACE_TIME_WAKE,    "time wake") \
+    X(TRACE_WEATHER_WAKE, "weather wake") \
+    X(TRACE_SNTP_SYNC,    "sntp sync") \
+    X(TRACE_HTTP_DONE,    "http response") \
+    X(TRACE_QUEUE_SEND,   "xQueueSend") \
+    X(TRACE_QUEUE_RECV,   "xQueueReceive") \
+    X(TRACE_LOCK,         "lvgl lock") \
+    X(TRACE_LABEL_SET,    "label set") \
+    X(TRACE_RENDER,       "render") \
+    X(TRACE_FLUSH,        "flush") \
+    X(TRACE_TLS_HANDSHAKE, "tls handshake")
+
+#define TRACE_ID(id, name) id,
+typedef enum {
+    TRACE_STAGES(TRACE_ID)
+    TRACE_STAGE_COUNT
+} TraceStage;
+#undef TRACE_ID
+
+#if TRACE_ENABLE
+#define TRACE_BEGIN(stage, arg) trace_event(stage, 'B', arg)
+#define TRACE_END(stage, arg) trace_event(stage, 'E', arg)
+#define TRACE_MARK(stage, arg) trace_event(stage, 'i', arg)
+#else
+#define TRACE_BEGIN(stage, arg)
+#define TRACE_END(stage, arg)
+#define TRACE_MARK(stage, arg)
+#endif
+
+void trace_event(TraceStage stage, char phase, uint16_t arg);
+void trace_dump_json();
+
+#endif // trace
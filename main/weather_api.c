@@ -10,31 +10,238 @@ This file is used to connect and check wifi status, as well as access the Open M
 #include "esp_http_client.h"
 #include "freertos/event_groups.h"
 #include "esp_event.h"
-#include "cJSON.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
 #include "creds.h"
+#include "task_plan.h"
+#include "metrics.h"
+#include "dns_cache.h"
+#include "weather_api.h"
+#include "timewarp.h"
+#include "blog.h"
+#include "trace.h"
+#include "tls_fetch.h"
+#include "gzip_stream.h"
+#include "json_stream.h"
 
 //API URL
-#define API_URL "http://api.open-meteo.com/v1/forecast?latitude=40.7799&longitude=-73.8051&current=temperature_2m,precipitation,weather_code&timezone=America%2FNew_York&temperature_unit=fahrenheit&precipitation_unit=inch"
-//precipiation amount, temperature, weather code in NYC, New York in Fahrenheit and inches of precipitation
+#define API_PATH "/v1/forecast?latitude=40.7799&longitude=-73.8051&current=temperature_2m,precipitation,weather_code&daily=weather_code,temperature_2m_max,temperature_2m_min&forecast_days=" STR(FORECAST_DAYS) "&timezone=America%2FNew_York&temperature_unit=fahrenheit&precipitation_unit=inch"
+//precipiation amount, temperature, weather code and the daily forecast in NYC, New York in Fahrenheit and inches of precipitation
+#define STR_(x) #x
+#define STR(x) STR_(x)
 
 //Static variables
 static EventGroupHandle_t wifi_event_group;
+static StaticEventGroup_t wifi_event_group_buffer;
 const int CONNECTED_BIT = BIT0;
-#define HTTP_BUFFER_MAX 1024
 
-static char response_buffer[HTTP_BUFFER_MAX];  // Store the HTTP response
-static int response_len = 0;
+static float forecast[MAX_ITEM_SIZE];          // {LENGTH, MAX, MIN, CODE, ...}, LENGTH is 0 until a forecast arrives
+
+//Where a provider's JSON keeps the numbers: the key of the enclosing object, then the key of each value
+//The daily values are arrays, one element per forecast day
+typedef struct {
+    const char* current;
+    const char* current_keys[3]; //temperature, precipitation, weather code
+    const char* daily;
+    const char* daily_keys[3];   //max, min, weather code
+} ApiKeys;
+
+static const ApiKeys open_meteo_keys = {
+    "current", {"temperature_2m", "precipitation", "weather_code"},
+    "daily", {"temperature_2m_max", "temperature_2m_min", "weather_code"},
+};
+
+//A weather source, the table is API_PROVIDERS in weather_api.h
+typedef struct {
+    const char* name;
+    const char* host;
+    const char* addr;
+    const char* port;
+    const char* path;
+    const ApiKeys* keys;
+    bool gzip;
+} Provider;
+
+#define PROVIDER_ID(id, name, host, addr, port, path, keys, gzip) id,
+enum { API_PROVIDERS(PROVIDER_ID) PROVIDER_COUNT };
+#undef PROVIDER_ID
+#define PROVIDER_ENTRY(id, name, host, addr, port, path, keys, gzip) { name, host, addr, port, path, &keys, gzip },
+static const Provider providers[PROVIDER_COUNT] = { API_PROVIDERS(PROVIDER_ENTRY) };
+#undef PROVIDER_ENTRY
+#define HEDGE_ON (API_HEDGE && PROVIDER_COUNT > 1)
+#if API_BACKUP && !API_MOCK
+_Static_assert(__builtin_strcmp(API_BACKUP_HOST, API_HOST) != 0, "a backup on the primary's host is no failover");
+#endif
+
+//The answer of one provider, inflated if it came gzipped and scanned as it passes, it is never stored whole
+typedef struct {
+    GzipStream* gzip;          //NULL when the provider is asked for plain JSON
+    JsonStream json;
+    const ApiKeys* keys;       //of the provider asked
+    bool started;
+    bool compressed;
+    uint32_t bytes;            //JSON scanned
+    float values[WEATHER_ITEM_SIZE];
+    float forecast[FORECAST_ITEM_SIZE];
+    uint32_t found;            //bit per value seen, the current values first, then the forecast days
+} Body;
+
+static Body bodies[PROVIDER_COUNT];
+#if API_GZIP
+static GzipStream gzip;
+static uint8_t gzip_plain_left = 0; //fetches still asking for plain JSON, set when a body needed more than GZIP_WINDOW
+static bool gzip_far = false;       //the fetch in progress failed on that, it is retried plain straight away
+#endif
+#define BODY_CURRENT_BITS 0x7u
+#define BODY_FORECAST_BITS (((1u << (FORECAST_DAYS * 3)) - 1) << 3)
+
+#if API_HTTPS
+static TlsConn conns[PROVIDER_COUNT];
+#else
+//The HTTP client is created once and reused so its buffers are not reallocated every fetch
+static esp_http_client_handle_t client = NULL;
+static char api_url[sizeof(API_PATH) + 32];
+#endif
+
+//Last good access point and DHCP lease, kept in NVS for a directed connect on boot
+#define WIFI_CACHE_NS "wifi_cache"
+#define WIFI_CACHE_KEY "last_ap"
+#define RECONNECT_MIN_MS 500
+#define RECONNECT_MAX_MS (1000 * 60)
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+    esp_netif_ip_info_t ip_info;
+    esp_ip4_addr_t dns;
+} WifiCache;
+
+static WifiCache wifi_cache;
+static bool fast_path = false; //connecting with the cached BSSID, channel and static IP
+static esp_netif_t *sta_netif = NULL;
+static esp_timer_handle_t reconnect_timer = NULL;
+static uint32_t reconnect_delay_ms = RECONNECT_MIN_MS;
+static int64_t connect_start_us = 0;
+static bool wifi_parked = false; //radio turned off on purpose between network windows
+
+static bool wifi_cache_load(){
+    nvs_handle_t nvs;
+    size_t len = sizeof(wifi_cache);
+    if(nvs_open(WIFI_CACHE_NS, NVS_READONLY, &nvs) != ESP_OK){
+        return false;
+    }
+    esp_err_t err = nvs_get_blob(nvs, WIFI_CACHE_KEY, &wifi_cache, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(wifi_cache) && wifi_cache.channel != 0;
+}
+
+static void wifi_cache_store(const WifiCache *entry){
+    nvs_handle_t nvs;
+    if(memcmp(entry, &wifi_cache, sizeof(wifi_cache)) == 0){ //unchanged, save a flash write
+        return;
+    }
+    wifi_cache = *entry;
+    if(nvs_open(WIFI_CACHE_NS, NVS_READWRITE, &nvs) == ESP_OK){
+        nvs_set_blob(nvs, WIFI_CACHE_KEY, &wifi_cache, sizeof(wifi_cache));
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+static void wifi_cache_clear(){
+    nvs_handle_t nvs;
+    memset(&wifi_cache, 0, sizeof(wifi_cache));
+    if(nvs_open(WIFI_CACHE_NS, NVS_READWRITE, &nvs) == ESP_OK){
+        nvs_erase_key(nvs, WIFI_CACHE_KEY);
+        nvs_commit(nvs);
+        nvs_close(nvs);
+    }
+}
+
+//Builds the station config, directed at the cached access point when fast is set
+static void wifi_apply_config(bool fast){
+    wifi_config_t wifi_config = {
+        .sta = {
+            .ssid = SSID,
+            .password = PASSWORD,
+            .threshold.authmode = WIFI_AUTH_WPA2_PSK  // Enforce WPA2
+        },
+    };
+    if(fast){ //skip the scan, go straight to the known channel and BSSID
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, wifi_cache.bssid, sizeof(wifi_cache.bssid));
+        wifi_config.sta.channel = wifi_cache.channel;
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+
+        esp_netif_dhcpc_stop(sta_netif); //reuse the last lease instead of DHCP
+        esp_netif_set_ip_info(sta_netif, &wifi_cache.ip_info);
+        esp_netif_dns_info_t dns = { .ip.u_addr.ip4 = wifi_cache.dns, .ip.type = ESP_IPADDR_TYPE_V4 };
+        esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns);
+    }
+    else{
+        wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+        esp_netif_dhcpc_start(sta_netif);
+    }
+    fast_path = fast;
+    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+}
+
+static void reconnect_cb(void *arg){
+    connect_start_us = esp_timer_get_time();
+    esp_wifi_connect();
+}
+
+//Saves the access point and lease that just worked
+static void wifi_remember(const esp_netif_ip_info_t *ip_info){
+    WifiCache entry = {0};
+    wifi_ap_record_t ap_info;
+    esp_netif_dns_info_t dns;
+    if(esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK){
+        return;
+    }
+    memcpy(entry.bssid, ap_info.bssid, sizeof(entry.bssid));
+    entry.channel = ap_info.primary;
+    entry.ip_info = *ip_info;
+    if(esp_netif_get_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns) == ESP_OK){
+        entry.dns = dns.ip.u_addr.ip4;
+    }
+    wifi_cache_store(&entry);
+}
 
 static void wifi_event_handler(void *arg, esp_event_base_t event_base, int32_t event_id, void *event_data) {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        ESP_LOGI("WiFi", "Wi-Fi started, connecting...");
+        ESP_LOGI("WiFi", "Wi-Fi started, connecting (%s)...", fast_path ? "cached AP" : "full scan");
+        connect_start_us = esp_timer_get_time();
         esp_wifi_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        ESP_LOGW("WiFi", "Disconnected from Wi-Fi, retrying...");
-        esp_wifi_connect();
+        xEventGroupClearBits(wifi_event_group, CONNECTED_BIT);
+        if(wifi_parked){ //disconnect caused by wifi_down
+            return;
+        }
+        app_metrics.wifi_disconnects++;
+        if(fast_path){ //cached AP or lease is stale, forget it and do a full scan with DHCP
+            ESP_LOGW("WiFi", "Cached AP failed, falling back to full scan");
+            wifi_cache_clear();
+            wifi_apply_config(false);
+            connect_start_us = esp_timer_get_time();
+            esp_wifi_connect();
+            return;
+        }
+        ESP_LOGW("WiFi", "Disconnected from Wi-Fi, retrying in %lu ms", reconnect_delay_ms);
+        esp_timer_stop(reconnect_timer);
+        esp_timer_start_once(reconnect_timer, (uint64_t)reconnect_delay_ms * 1000);
+        reconnect_delay_ms *= 2;
+        if(reconnect_delay_ms > RECONNECT_MAX_MS){
+            reconnect_delay_ms = RECONNECT_MAX_MS;
+        }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *) event_data;
-        ESP_LOGI("WiFi", "Got IP: " IPSTR, IP2STR(&event->ip_info.ip));
+        app_metrics.wifi_time_to_ip_ms = (esp_timer_get_time() - connect_start_us) / 1000;
+        app_metrics.wifi_fast_path = fast_path;
+        ESP_LOGI("WiFi", "Got IP: " IPSTR " in %lu ms (%s)", IP2STR(&event->ip_info.ip),
+        app_metrics.wifi_time_to_ip_ms, fast_path ? "cached AP" : "full scan");
+        reconnect_delay_ms = RECONNECT_MIN_MS;
+        wifi_remember(&event->ip_info);
         xEventGroupSetBits(wifi_event_group, CONNECTED_BIT);
     }
 }
@@ -43,33 +250,31 @@ void wifi_setup(){
     ESP_LOGI("WiFi", "WiFi intitializing");
     // Initialize NVS (Non-Volatile Storage)
     ESP_ERROR_CHECK(nvs_flash_init());
+    dns_cache_init();
 
     ESP_ERROR_CHECK(esp_netif_init());  
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    sta_netif = esp_netif_create_default_wifi_sta();
 
     // Initialize Wi-Fi driver
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
-    wifi_event_group = xEventGroupCreate();
+    wifi_event_group = xEventGroupCreateStatic(&wifi_event_group_buffer);
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_handler, NULL, NULL));
     ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, &wifi_event_handler, NULL, NULL));
 
+    const esp_timer_create_args_t timer_args = {
+        .callback = reconnect_cb,
+        .name = "wifi_reconnect",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &reconnect_timer));
+
     // Set Wi-Fi mode to STA (Station mode)
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
 
-    // Set Wi-Fi credentials (SSID and password)
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = SSID,
-            .password = PASSWORD,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK  // Enforce WPA2
-        },
-    };
-
-    //Set config and start Wi-Fi
-    ESP_ERROR_CHECK(esp_wifi_set_config(ESP_IF_WIFI_STA, &wifi_config));
+    //Set config, directed at the last good AP when one is cached, and start Wi-Fi
+    wifi_apply_config(wifi_cache_load());
 
     ESP_ERROR_CHECK(esp_wifi_start());
 
@@ -79,33 +284,166 @@ void wifi_setup(){
     ESP_LOGI("WiFi", "Connected to Wi-Fi, ready to make API calls");
 }
 
+//Turns the radio back on and waits for an IP, returns ESP_ERR_TIMEOUT if none arrives in time
+esp_err_t wifi_up(uint32_t timeout_ms){
+    if(wifi_parked){
+        wifi_parked = false;
+        reconnect_delay_ms = RECONNECT_MIN_MS;
+        ESP_ERROR_CHECK(esp_wifi_start()); //STA_START event connects
+    }
+    EventBits_t bits = xEventGroupWaitBits(wifi_event_group, CONNECTED_BIT, pdFALSE, pdTRUE, timeout_ms / portTICK_PERIOD_MS);
+    return (bits & CONNECTED_BIT) ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+//Turns the radio off until the next wifi_up
+void wifi_down(){
+    wifi_parked = true;
+    esp_timer_stop(reconnect_timer);
+    esp_wifi_stop();
+    xEventGroupClearBits(wifi_event_group, CONNECTED_BIT);
+}
+
 void check_wifi_status(){// Check the connection status periodically
     wifi_ap_record_t ap_info;
     esp_err_t err = esp_wifi_sta_get_ap_info(&ap_info);
     if (err == ESP_OK && ap_info.rssi != 0) {
-        ESP_LOGI("WiFi", "Connected to Wi-Fi. Signal strength: %d", ap_info.rssi);
+        BLOG(BLOG_WIFI_RSSI, ap_info.rssi);
         // ESP_LOGI("DEBUG", "Post run: %d bytes", uxTaskGetStackHighWaterMark(NULL));
     } 
     else {
-        ESP_LOGI("WiFi", "Not connected to Wi-Fi.");
+        BLOG(BLOG_WIFI_DOWN);
+    }
+}
+
+
+
+//Files the numbers the display uses: the current values and the daily forecast
+static void body_number(void* arg, const char* object, const char* key, int index, double value){
+    Body* body = arg;
+    const ApiKeys* keys = body->keys;
+    for(int i = 0; i < 3; ++i){
+        if(index < 0 && strcmp(object, keys->current) == 0 && strcmp(key, keys->current_keys[i]) == 0){
+            body->values[1 + i] = value;
+            body->found |= 1u << i;
+        }
+        else if(index >= 0 && index < FORECAST_DAYS && strcmp(object, keys->daily) == 0 && strcmp(key, keys->daily_keys[i]) == 0){
+            body->forecast[1 + index * 3 + i] = value;
+            body->found |= 1u << (3 + index * 3 + i);
+        }
     }
 }
 
+//JSON text, straight off the connection or out of the inflater
+static void body_json(void* arg, const char* data, int len){
+    Body* body = arg;
+    body->bytes += len;
+    json_stream_push(&body->json, data, len);
+}
 
+static void body_reset(Body* body, const ApiKeys* keys, bool inflate){
+    body->gzip = NULL;
+    body->keys = keys;
+#if API_GZIP
+    if(inflate){
+        body->gzip = &gzip;
+        gzip_init(&gzip, body_json, body);
+    }
+#endif
+    json_stream_init(&body->json, body_number, body);
+    body->started = false;
+    body->compressed = false;
+    body->bytes = 0;
+    body->found = 0;
+}
+
+//Takes the body a piece at a time, JSON never starts with the gzip magic so no header is needed to tell
+static void body_append(void* arg, const char* data, int len){
+    Body* body = arg;
+    if(!body->started){
+        body->started = true;
+        body->compressed = (uint8_t)data[0] == 0x1f;
+    }
+    if(!body->compressed){
+        body_json(body, data, len);
+    }
+    else if(body->gzip != NULL){ //gzip nobody asked for is left for body_valid to turn down
+        gzip_push(body->gzip, (const uint8_t *)data, len);
+    }
+}
+
+//Checks a complete body ended cleanly and had the current weather in it
+static bool body_valid(Body* body){
+    if(body->compressed && (body->gzip == NULL || body->gzip->status != GZIP_DONE)){
+        app_metrics.gzip_failures++;
+        if(body->gzip != NULL && body->gzip->status == GZIP_FAR){
+#if API_GZIP
+            gzip_far = true;
+            gzip_plain_left = GZIP_PLAIN_FETCHES;
+#endif
+            ESP_LOGW("API", "Body refers back more than %d bytes, asking for plain JSON for %d fetches",
+            GZIP_WINDOW, GZIP_PLAIN_FETCHES);
+        }
+        else{
+            ESP_LOGW("API", "Bad gzip body");
+        }
+        return false;
+    }
+    if(!json_stream_done(&body->json) || (body->found & BODY_CURRENT_BITS) != BODY_CURRENT_BITS){
+        ESP_LOGI("JSON","Missing weather values");
+        return false;
+    }
+    return true;
+}
+
+#if RECORD_SESSION
+//Two bodies may stream in at once, so the REC line is written from what the winner carried,
+//in the Open-Meteo form tools/mock_server.py --replay serves, whichever provider it came from
+static void body_record(const Body* body){
+    printf("REC %lld HTTP {\"current\":{\"temperature_2m\":%g,\"precipitation\":%g,\"weather_code\":%g}",
+    (long long)time(NULL), body->values[1], body->values[2], body->values[3]);
+    if((body->found & BODY_FORECAST_BITS) == BODY_FORECAST_BITS){
+        printf(",\"daily\":{");
+        for(int key = 0; key < 3; ++key){
+            printf("%s\"%s\":[", key > 0 ? "," : "", open_meteo_keys.daily_keys[key]);
+            for(int day = 0; day < FORECAST_DAYS; ++day){
+                printf("%s%g", day > 0 ? "," : "", body->forecast[1 + day * 3 + key]);
+            }
+            printf("]");
+        }
+        printf("}");
+    }
+    printf("}\n");
+}
+#endif
+
+//Hands the winning body to the display
+static void body_use(const Body* body, float* api_values){
+    memcpy(api_values, body->values, sizeof(body->values));
+    api_values[0] = WEATHER_ITEM_SIZE;
+    forecast[0] = 0;
+    if((body->found & BODY_FORECAST_BITS) == BODY_FORECAST_BITS){
+        memcpy(forecast, body->forecast, sizeof(body->forecast));
+        forecast[0] = FORECAST_ITEM_SIZE;
+    }
+    app_metrics.fetch_body_bytes = body->bytes;
+    app_metrics.fetch_gzip = body->compressed;
+#if API_GZIP
+    app_metrics.fetch_body_ram = sizeof(bodies) + sizeof(gzip);
+#else
+    app_metrics.fetch_body_ram = sizeof(bodies);
+#endif
+#if RECORD_SESSION
+    body_record(body);
+#endif
+}
 
 esp_err_t client_event_get_handler(esp_http_client_event_handle_t evt) //event handler for GET request
 {
     switch (evt->event_id)
     {
     case HTTP_EVENT_ON_DATA:
-        if(response_len + evt->data_len < HTTP_BUFFER_MAX){ //response doesnt exceed buffer
-            memcpy(response_buffer + response_len, evt->data, evt->data_len); //copy data to buffer
-            response_len += evt->data_len;
-            response_buffer[response_len] = '\0'; //null terminate 
-        }
-        else{
-            ESP_LOGI("API","Buffer too small");
-        }
+        app_metrics.fetch_wire_bytes += evt->data_len; //esp_http_client only shows the body
+        body_append(&bodies[PROVIDER_PRIMARY], evt->data, evt->data_len);
         // ESP_LOGI("API","%.*s\n", evt->data_len, (char *)evt->data);
         break;
 
@@ -115,55 +453,207 @@ esp_err_t client_event_get_handler(esp_http_client_event_handle_t evt) //event h
     return ESP_OK;
 }
 
+//Extra request headers, gzip is only asked for when the body can be inflated
+static const char* request_headers(int id){
+#if API_GZIP
+    return providers[id].gzip && gzip_plain_left == 0 ? "Accept-Encoding: gzip\r\n" : "";
+#else
+    return "";
+#endif
+}
 
-// Function to parse JSON and extract data
-void process_json_response(const char *json_str, float* api_values){
-    cJSON *root = cJSON_Parse(json_str);
-    if (root == NULL)
-    {
-        ESP_LOGI("JSON","Failed to parse JSON\n");
-        return;
+#if API_HTTPS
+//Fills addr with the IP to connect to, an address of NULL is looked up in the DNS cache
+//Done for every provider before the race, a cold cache blocks on the resolver while nothing is in flight yet
+static bool provider_address(int id, char* addr, size_t len){
+    const Provider* provider = &providers[id];
+    esp_ip4_addr_t ip;
+    if(provider->addr != NULL){
+        strlcpy(addr, provider->addr, len);
+        return true;
+    }
+    if(dns_cache_lookup(provider->host, &ip) != ESP_OK){
+        ESP_LOGW("API", "No address for the %s provider", provider->name);
+        return false;
     }
-    //ESP_LOGI("JSON","Json obj %s",cJSON_Print(root));
-    cJSON *values = cJSON_GetObjectItem(root, "current");
+    snprintf(addr, len, IPSTR, IP2STR(&ip));
+    return true;
+}
 
-    cJSON *temp = cJSON_GetObjectItem(values, "temperature_2m");
-    cJSON *precip = cJSON_GetObjectItem(values, "precipitation");
-    cJSON *w_code = cJSON_GetObjectItem(values, "weather_code");
-    //ESP_LOGI("JSON","Temperature: %.2f\n",temp->valuedouble);
+static void provider_start(int id, const char* addr){
+    const Provider* provider = &providers[id];
+    body_reset(&bodies[id], provider->keys, request_headers(id)[0] != '\0');
+    tls_start(&conns[id], id, addr, provider->port, provider->host, provider->path, request_headers(id), body_append, &bodies[id]);
+}
 
-    //ESP_LOGI("JSON","Temperature: %.1f \nPrec: %.2f\nWeather Code: %.1f\n",temp->valuedouble, precip->valuedouble, w_code->valuedouble);
-    api_values[0] = 4;
-    api_values[1] = temp->valuedouble;
-    api_values[2] = precip->valuedouble;
-    api_values[3] = w_code->valuedouble;
+//How long the primary gets before the backup is asked too: its HEDGE_PERCENTILE latency,
+//so about one fetch in twenty is hedged while the primary behaves
+static uint32_t hedge_deadline(){
+    uint32_t deadline_ms = HEDGE_DEFAULT_MS;
+    if(app_metrics.primary_samples >= HEDGE_MIN_SAMPLES){
+        deadline_ms = metrics_percentile(app_metrics.primary_ms, app_metrics.primary_samples, HEDGE_PERCENTILE);
+    }
+    return deadline_ms < HEDGE_MIN_MS ? HEDGE_MIN_MS : deadline_ms > API_TIMEOUT_MS ? API_TIMEOUT_MS : deadline_ms;
+}
+
+//Asks the primary, then each further provider one deadline later or as soon as everything asked so far failed
+//Returns the provider whose answer came back valid first, or -1
+static int providers_race(){
+    uint32_t deadline_ms = hedge_deadline();
+    bool judged[PROVIDER_COUNT] = {false};
+    char addrs[PROVIDER_COUNT][DNS_HOST_MAX];
+    if(!provider_address(PROVIDER_PRIMARY, addrs[PROVIDER_PRIMARY], sizeof(addrs[PROVIDER_PRIMARY]))){
+        strlcpy(addrs[PROVIDER_PRIMARY], providers[PROVIDER_PRIMARY].host, DNS_HOST_MAX); //resolved on connect, nothing else is in flight then
+    }
+    int count = 1; //providers that can be asked, backups stop at the first without an address
+    while(count < PROVIDER_COUNT && provider_address(count, addrs[count], sizeof(addrs[count]))){
+        count++;
+    }
+    int64_t start_us = esp_timer_get_time();
+    int started = 1;
+    int winner = -1;
+    app_metrics.hedge_deadline_ms = deadline_ms;
+    provider_start(PROVIDER_PRIMARY, addrs[PROVIDER_PRIMARY]);
+
+    while(1){
+        uint32_t elapsed_ms = (esp_timer_get_time() - start_us) / 1000;
+        int running = 0;
+        for(int id = 0; id < started && winner < 0; ++id){
+            TlsConn* conn = &conns[id];
+            if(conn->state != TLS_DONE && conn->state != TLS_FAILED){
+                running++;
+            }
+            else if(!judged[id]){
+                judged[id] = true;
+                if(conn->state == TLS_DONE && conn->status == 200 && body_valid(&bodies[id])){
+                    winner = id;
+                }
+                else{
+                    ESP_LOGW("API", "The %s provider failed, status %d", providers[id].name, conn->status);
+                    app_metrics.primary_failures += id == PROVIDER_PRIMARY;
+                }
+            }
+        }
+        if(winner >= 0 || elapsed_ms >= API_TIMEOUT_MS){
+            break;
+        }
+        if(HEDGE_ON && started < count && (running == 0 || elapsed_ms >= deadline_ms * started)){
+            ESP_LOGI("API", "%s after %lu ms, asking the %s provider", running == 0 ? "Failed" : "No answer",
+            elapsed_ms, providers[started].name);
+            app_metrics.hedges++;
+            provider_start(started, addrs[started]);
+            started++;
+            continue;
+        }
+        if(running == 0){
+            break;
+        }
+        uint32_t wait_ms = API_TIMEOUT_MS - elapsed_ms;
+        if(HEDGE_ON && started < count && deadline_ms * started - elapsed_ms < wait_ms){
+            wait_ms = deadline_ms * started - elapsed_ms;
+        }
+        tls_wait(conns, started, wait_ms);
+    }
 
-    cJSON_Delete(root);  // Free memory
+    //A primary dropped for a faster answer counts with the time it ran, its real latency is at least that.
+    //Failures do not count, they end early and would pull the deadline down.
+    TlsConn* primary = &conns[PROVIDER_PRIMARY];
+    if(winner == PROVIDER_PRIMARY || (primary->state != TLS_DONE && primary->state != TLS_FAILED)){
+        int64_t end_us = winner == PROVIDER_PRIMARY ? primary->end_us : esp_timer_get_time();
+        metrics_record_latency(app_metrics.primary_ms, &app_metrics.primary_samples, (end_us - start_us) / 1000);
+    }
+    if(winner >= 0){
+        metrics_record_latency(app_metrics.answer_ms, &app_metrics.answer_samples, (conns[winner].end_us - start_us) / 1000);
+        app_metrics.hedge_wins += winner != PROVIDER_PRIMARY;
+    }
+    TRACE_MARK(TRACE_HTTP_DONE, winner >= 0 ? conns[winner].status : 0);
+    for(int id = 0; id < started; ++id){
+        tls_close(&conns[id]);
+    }
+    return winner;
 }
+#endif
 
-void api_get(float* api_values){ //api get request
-    //Reset buffer
-    memset(response_buffer, 0, response_len);
-    response_len = 0;
+//One request, raced across the providers over HTTPS, returns the provider with a valid body or -1
+static int api_fetch(){
+#if API_HTTPS
+    return providers_race();
+#else
+    //Connect to the cached address, the Host header keeps the virtual host
+    esp_ip4_addr_t addr;
+    if(dns_cache_lookup(API_HOST, &addr) == ESP_OK){
+        snprintf(api_url, sizeof(api_url), "http://" IPSTR "%s", IP2STR(&addr), API_PATH);
+    }
+    else{
+        snprintf(api_url, sizeof(api_url), "http://%s%s", API_HOST, API_PATH);
+    }
 
-    esp_http_client_config_t config_get = {
-        .url = API_URL,
-        .method = HTTP_METHOD_GET,
-        .cert_pem = NULL,
-        .event_handler = client_event_get_handler};
+    if(client == NULL){
+        esp_http_client_config_t config_get = {
+            .url = api_url,
+            .method = HTTP_METHOD_GET,
+            .cert_pem = NULL,
+            .event_handler = client_event_get_handler};
+        client = esp_http_client_init(&config_get);
+    }
+    else{
+        esp_http_client_set_url(client, api_url);
+    }
         
-    //Run http request
-    esp_http_client_handle_t client = esp_http_client_init(&config_get);
-    esp_http_client_perform(client);
-    esp_http_client_cleanup(client);
+    //Run http request, only the primary on this path
+    body_reset(&bodies[PROVIDER_PRIMARY], providers[PROVIDER_PRIMARY].keys, request_headers(PROVIDER_PRIMARY)[0] != '\0');
+    esp_http_client_set_header(client, "Host", API_HOST);
+    if(request_headers(PROVIDER_PRIMARY)[0] != '\0'){
+        esp_http_client_set_header(client, "Accept-Encoding", "gzip");
+    }
+    else{
+        esp_http_client_delete_header(client, "Accept-Encoding");
+    }
+    esp_err_t err = esp_http_client_perform(client);
+    int status = esp_http_client_get_status_code(client);
+    TRACE_MARK(TRACE_HTTP_DONE, status);
+    esp_http_client_close(client); //drop the socket, the radio goes off after the window
+    if (err != ESP_OK || status != 200){
+        ESP_LOGW("API","Request failed: %s, status %d", esp_err_to_name(err), status);
+    }
+    return err == ESP_OK && status == 200 && body_valid(&bodies[PROVIDER_PRIMARY]) ? PROVIDER_PRIMARY : -1;
+#endif
+}
 
-    // ESP_LOGI("API","DONE: %d",response_len);
+esp_err_t api_get(float* api_values){ //api get request, returns ESP_OK when api_values was updated
+    app_metrics.fetch_wire_bytes = 0; //a plain retry adds to it, both went over the air
+    app_metrics.fetch_body_bytes = 0;
 
-    if (response_len > 0)  
-    {
-        process_json_response(response_buffer,api_values);
-        ESP_LOGI("API","Content is done");
+#if API_GZIP
+    if(gzip_plain_left > 0){
+        gzip_plain_left--;
+    }
+    gzip_far = false;
+#endif
+    int winner = api_fetch();
+#if API_GZIP
+    if(winner < 0 && gzip_far){ //the answer was there, only too far back for the window
+        ESP_LOGI("API", "Asking again for plain JSON");
+        winner = api_fetch();
+    }
+#endif
+
+    app_metrics.largest_free_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    if(app_metrics.largest_free_block_min == 0 || app_metrics.largest_free_block < app_metrics.largest_free_block_min){
+        app_metrics.largest_free_block_min = app_metrics.largest_free_block;
     }
-}
 
+    if(winner < 0){
+        ESP_LOGW("API","No valid answer from any provider");
+        return ESP_FAIL;
+    }
+    body_use(&bodies[winner], api_values);
+    ESP_LOGI("API","Content is done, %lu bytes received for %lu bytes of JSON from the %s provider",
+    app_metrics.fetch_wire_bytes, app_metrics.fetch_body_bytes, providers[winner].name);
+    return ESP_OK;
+}
 
+//Forecast from the last successful api_get, forecast[0] is 0 when there is none
+const float* api_forecast(){
+    return forecast;
+}
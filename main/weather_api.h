@@ -1,10 +1,65 @@
 #ifndef weather_api
 #define weather_api
 
+#include "stdint.h"
+#include "esp_err.h"
+
+#define API_HOST "api.open-meteo.com"
+//1 fetches over TLS with the pinned roots in tls_ca.h, 0 falls back to plain HTTP through esp_http_client
+#define API_HTTPS 1
+#define API_PORT "443"
+//Bodies are always scanned as they stream in (json_stream.c), 1 also asks the primary for gzip
+//and inflates it on the way (gzip_stream.c), 0 asks for plain JSON and leaves out the window
+#define API_GZIP 1
+#define GZIP_PLAIN_FETCHES 24 //after a body reaching back past the inflater window, fetches asked for plain JSON
+
+//1 fetches from tools/mock_server.py on the LAN instead, over TLS with the certificate it made
+//Run one instance per provider, the backup on API_MOCK_BACKUP_PORT
+#define API_MOCK 0
+#define API_MOCK_IP "192.168.1.20"
+#define API_MOCK_PORT "8443"
+#define API_MOCK_BACKUP_PORT "8444"
+
+//1 adds a second weather source for the hedge. It must be another service, or at least other servers
+//(a self-hosted Open-Meteo): the same host gets the same DNS answer and is down whenever the primary is.
+//The host needs its roots in tls_ca.h, the path asks for the units the display shows (F, inches)
+//and the key table in weather_api.c says where its JSON keeps the numbers
+#define API_BACKUP 0
+#define API_BACKUP_HOST "weather.example.net"
+#define API_BACKUP_PATH API_PATH
+#define API_BACKUP_KEYS open_meteo_keys
+
+//X(id, name, host for SNI and Host, address or NULL for the DNS cache, port, path, key table, ask for gzip)
+//Only the primary may ask for gzip, there is one inflater. The mock backup is a second mock_server.py instance.
+#if API_MOCK
+#define API_PROVIDERS(X) \
+    X(PROVIDER_PRIMARY, "primary", API_HOST,        API_MOCK_IP, API_MOCK_PORT,        API_PATH,        open_meteo_keys, API_GZIP) \
+    X(PROVIDER_BACKUP,  "backup",  API_HOST,        API_MOCK_IP, API_MOCK_BACKUP_PORT, API_PATH,        open_meteo_keys, 0)
+#elif API_BACKUP
+#define API_PROVIDERS(X) \
+    X(PROVIDER_PRIMARY, "primary", API_HOST,        NULL,        API_PORT,             API_PATH,        open_meteo_keys, API_GZIP) \
+    X(PROVIDER_BACKUP,  "backup",  API_BACKUP_HOST, NULL,        API_PORT,             API_BACKUP_PATH, API_BACKUP_KEYS, 0)
+#else
+#define API_PROVIDERS(X) \
+    X(PROVIDER_PRIMARY, "primary", API_HOST,        NULL,        API_PORT,             API_PATH,        open_meteo_keys, API_GZIP)
+#endif
+
+//1 starts the backup when the primary has not answered by its HEDGE_PERCENTILE latency or failed,
+//whichever answers first with the weather wins and the other connection is dropped. HTTPS only.
+//Without a backup in API_PROVIDERS there is nothing to hedge to and it compiles out.
+#define API_HEDGE 1
+#define HEDGE_PERCENTILE 95
+#define HEDGE_MIN_SAMPLES 8     //primary latencies needed before the percentile is trusted
+#define HEDGE_DEFAULT_MS 1500   //deadline until then
+#define HEDGE_MIN_MS 250        //never hedge sooner, a fast run of samples would double every request
+#define API_TIMEOUT_MS 10000    //whole fetch, hedge included
+
 void wifi_setup();
+esp_err_t wifi_up(uint32_t timeout_ms);
+void wifi_down();
 void check_wifi_status();
 // void api_call();
-void api_get(float* api_values);
-void process_json_response(const char *json_str, float* api_values);
+esp_err_t api_get(float* api_values);
+const float* api_forecast();
 
 #endif // weather_api
\ No newline at end of file
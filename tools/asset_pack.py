@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+"""
+Packs LVGL font sources (the .c files lv_font_conv writes) into the blob
+read by main/asset_store.c, so fonts can be flashed without rebuilding the app.
+
+    python tools/asset_pack.py -o assets.bin text=main/fonts/jetbrains_mono_16.c symbols=main/fonts/weather_symbols.c
+    parttool.py write_partition --partition-name assets --input assets.bin
+
+Names must match font_names in asset_store.c. Only the uncompressed,
+tiny cmap formats are supported, which is what lv_font_conv emits here.
+"""
+
+import argparse
+import re
+import struct
+import sys
+import zlib
+
+ASSET_MAGIC = 0x31534157  # "WAS1"
+ASSET_FORMAT_VERSION = 1
+ASSET_MAX_CMAPS = 4
+HEADER = struct.Struct("<IHHII")
+FONT = struct.Struct("<12sBBBBbBHIII")
+CMAP = struct.Struct("<IHHHBxI")
+CMAP_TYPES = {"LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY": 2, "LV_FONT_FMT_TXT_CMAP_SPARSE_TINY": 3}
+
+GLYPH_RE = re.compile(r"\{\.bitmap_index = (\d+), \.adv_w = (\d+), \.box_w = (\d+), \.box_h = (\d+), "
+                      r"\.ofs_x = (-?\d+), \.ofs_y = (-?\d+)\}")
+CMAP_RE = re.compile(r"\.range_start = (\d+), \.range_length = (\d+), \.glyph_id_start = (\d+),\s*"
+                     r"\.unicode_list = (\w+), \.glyph_id_ofs_list = (\w+), \.list_length = (\d+), \.type = (\w+)")
+
+
+def strip_comments(text):
+    return re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+
+
+def array_body(text, name):
+    match = re.search(name + r"\[\] = \{(.*?)\};", text, re.S)
+    if match is None:
+        raise ValueError("no array " + name)
+    return match.group(1)
+
+
+def field(text, name):
+    return int(re.search(r"\." + name + r" = (-?\d+)", text).group(1))
+
+
+def parse_font(path):
+    """Reads one lv_font_conv source into plain python values."""
+    with open(path) as src:
+        raw = src.read()
+    text = strip_comments(raw)
+    font = {
+        "bitmap": bytes(int(v, 16) for v in re.findall(r"0x[0-9a-fA-F]+", array_body(text, "glyph_bitmap"))),
+        "glyphs": [tuple(int(v) for v in g) for g in GLYPH_RE.findall(raw)],
+        "cmaps": [],
+        "bpp": field(text, "bpp"),
+        "line_height": field(text, "line_height"),
+        "base_line": field(text, "base_line"),
+        "underline_position": field(text, "underline_position"),
+        "underline_thickness": field(text, "underline_thickness"),
+    }
+    if "LV_FONT_FMT_TXT_PLAIN" not in text and ".bitmap_format = 0" not in text:
+        raise ValueError(path + ": compressed fonts are not supported")
+    for start, length, gid, ulist, ofs_list, list_len, ctype in CMAP_RE.findall(text):
+        if ctype not in CMAP_TYPES or ofs_list != "NULL":
+            raise ValueError(path + ": cmap type " + ctype + " is not supported")
+        unicode_list = []
+        if ulist != "NULL":
+            unicode_list = [int(v, 0) for v in re.findall(r"0x[0-9a-fA-F]+|\d+", array_body(text, ulist))]
+        font["cmaps"].append({"start": int(start), "length": int(length), "gid": int(gid),
+                              "type": CMAP_TYPES[ctype], "list": unicode_list})
+    return font
+
+
+def align4(data):
+    return data + b"\0" * (-len(data) % 4)
+
+
+def pack(fonts):
+    """fonts is a list of (name, font), returns the blob."""
+    table_ofs = HEADER.size + FONT.size * len(fonts)
+    entries = b""
+    tables = b""
+    for name, font in fonts:
+        if len(font["cmaps"]) > ASSET_MAX_CMAPS:
+            raise ValueError(name + ": too many cmaps")
+        glyph_ofs = table_ofs + len(tables)
+        for bitmap_index, adv_w, box_w, box_h, ofs_x, ofs_y in font["glyphs"]:
+            tables += struct.pack("<IBBbb", bitmap_index | (adv_w << 20), box_w, box_h, ofs_x, ofs_y)
+        lists = b""
+        cmap_records = []
+        list_base = table_ofs + len(tables) + CMAP.size * len(font["cmaps"])
+        for cmap in font["cmaps"]:
+            unicode_ofs = 0
+            if cmap["list"]:
+                unicode_ofs = list_base + len(lists)
+                lists = align4(lists + struct.pack("<%dH" % len(cmap["list"]), *cmap["list"]))
+            cmap_records.append(CMAP.pack(cmap["start"], cmap["length"], cmap["gid"], len(cmap["list"]),
+                                          cmap["type"], unicode_ofs))
+        cmap_ofs = table_ofs + len(tables)
+        tables += b"".join(cmap_records) + lists
+        bitmap_ofs = table_ofs + len(tables)
+        tables = align4(tables + font["bitmap"])
+        entries += FONT.pack(name.encode()[:12], font["line_height"], font["base_line"], font["bpp"],
+                             len(font["cmaps"]), font["underline_position"], font["underline_thickness"],
+                             len(font["glyphs"]), glyph_ofs, cmap_ofs, bitmap_ofs)
+    body = entries + tables
+    size = HEADER.size + len(body)
+    return HEADER.pack(ASSET_MAGIC, ASSET_FORMAT_VERSION, len(fonts), size, zlib.crc32(body)) + body
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("fonts", nargs="+", help="name=path/to/font.c")
+    parser.add_argument("-o", "--out", required=True)
+    parser.add_argument("--max-size", type=int, default=64 * 1024, help="size of the assets partition")
+    args = parser.parse_args()
+
+    fonts = []
+    for spec in args.fonts:
+        name, path = spec.split("=", 1)
+        fonts.append((name, parse_font(path)))
+    blob = pack(fonts)
+    if len(blob) > args.max_size:
+        print("blob is %d bytes, partition only holds %d" % (len(blob), args.max_size))
+        return 1
+    with open(args.out, "wb") as out:
+        out.write(blob)
+    print("%s: %d bytes, %d fonts" % (args.out, len(blob), len(fonts)))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+"""
+Turns the binary records written by main/blog.c back into ESP_LOG style lines.
+Text around the records (normal ESP_LOG output) is passed through in order.
+
+The serial stream has to be captured raw, idf.py monitor rewrites it:
+    python -m serial.tools.miniterm --raw /dev/ttyUSB0 115200 > run.bin
+    python tools/blog_decode.py run.bin
+
+Formats come from BLOG_FORMATS in main/blog.h, so decode with the same
+revision of the header that the firmware was built from.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+BLOG_MAGIC = 0xB7
+BLOG_ESC = 0xDB
+UNESCAPE = {0xDC: 0x0A, 0xDD: BLOG_ESC}
+BLOG_MAX_ARGS = 6
+HEADER = struct.Struct("<BBBBI")
+FORMAT_RE = re.compile(r'X\((\w+),\s*"([^"]*)",\s*"((?:[^"\\]|\\.)*)"\)')
+CONV_RE = re.compile(r"%([-+ 0#]*\d*(?:\.\d+)?)(?:hh|h|ll|l|z)?([a-zA-Z%])")
+
+
+def load_formats(header):
+    with open(header) as src:
+        return [(tag, fmt.encode().decode("unicode_escape")) for _, tag, fmt in FORMAT_RE.findall(src.read())]
+
+
+def render(fmt, args):
+    """Formats raw 32 bit arguments the way printf would have."""
+    values = list(args)
+
+    def convert(match):
+        flags, conv = match.groups()
+        if conv == "%":
+            return "%"
+        raw = values.pop(0) if values else 0
+        if conv in "di":
+            return ("%" + flags + "d") % struct.unpack("<i", struct.pack("<I", raw))[0]
+        if conv in "feEgG":
+            return ("%" + flags + conv) % struct.unpack("<f", struct.pack("<I", raw))[0]
+        if conv in "uxXo":
+            return ("%" + flags + ("d" if conv == "u" else conv)) % raw
+        if conv == "c":
+            return chr(raw & 0xFF)
+        return "<%" + conv + "?>"
+
+    return CONV_RE.sub(convert, fmt)
+
+
+def unescape(data, i, count):
+    """Reads count record bytes from data[i:], returns them and the index after, or None if cut short."""
+    out = bytearray()
+    while len(out) < count:
+        if i >= len(data):
+            return None
+        if data[i] == BLOG_ESC:
+            if i + 1 >= len(data) or data[i + 1] not in UNESCAPE:
+                return None
+            out.append(UNESCAPE[data[i + 1]])
+            i += 2
+        else:
+            out.append(data[i])
+            i += 1
+    return bytes(out), i
+
+
+def decode(data, formats):
+    """Yields output lines, records and plain text in stream order."""
+    text = bytearray()
+    i = 0
+    while i < len(data):
+        head = unescape(data, i + 1, HEADER.size - 1) if data[i] == BLOG_MAGIC else None
+        if head:
+            _, fmt_id, nargs, reserved, time_ms = HEADER.unpack(bytes([BLOG_MAGIC]) + head[0])
+            body = unescape(data, head[1], 4 * nargs) if nargs <= BLOG_MAX_ARGS else None
+            if fmt_id < len(formats) and reserved == 0 and body:
+                if text:
+                    yield text.decode(errors="replace")
+                    text = bytearray()
+                args = struct.unpack("<%dI" % nargs, body[0])
+                tag, fmt = formats[fmt_id]
+                yield "I (%d) %s: %s\n" % (time_ms, tag, render(fmt, args))
+                i = body[1]
+                continue
+        text.append(data[i])
+        i += 1
+    if text:
+        yield text.decode(errors="replace")
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("capture", help="raw serial capture")
+    parser.add_argument("--header", default=os.path.join(ROOT, "main", "blog.h"))
+    args = parser.parse_args()
+
+    formats = load_formats(args.header)
+    with open(args.capture, "rb") as src:
+        data = src.read()
+    for chunk in decode(data, formats):
+        sys.stdout.write(chunk)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+Cuts the fonts in main/fonts down to the glyphs the firmware can actually draw.
+
+The full lv_font_conv output lives in tools/fonts. This script collects every
+string the UI can render from the label sources (format strings, literals, the
+weather code table and the icon macros), expands the format specifiers into the
+characters they can produce, and writes main/fonts/<font>.c with only those glyphs.
+
+    python tools/font_subset.py          # regenerate main/fonts and report the flash saved
+    python tools/font_subset.py --check  # fail if a rendered string needs a glyph the subset lacks
+
+Run --check before every build; it also fails when the full font is missing a glyph.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+from asset_pack import parse_font
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+UI_SOURCES = ["main/i2c_oled.c", "main/info_pages.c", "main/graph_page.c"]
+FONTS = [
+    ("tools/fonts/jetbrains_mono_16.c", "main/fonts/jetbrains_mono_16.c"),
+    ("tools/fonts/weather_symbols.c", "main/fonts/weather_symbols.c"),
+]
+
+DIGITS = "0123456789"
+DAY_NAMES = ["Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"]
+# Characters each conversion can print, %s only ever carries a strftime result in the UI files
+PRINTF_CHARS = {"d": DIGITS + "-", "i": DIGITS + "-", "u": DIGITS, "f": DIGITS + ".-", "c": "", "%": "%"}
+STRFTIME_CHARS = {"I": DIGITS, "H": DIGITS, "M": DIGITS, "S": DIGITS, "m": DIGITS, "d": DIGITS,
+                  "y": DIGITS, "Y": DIGITS, "p": "AMP", "a": "".join(DAY_NAMES), "%": "%"}
+PRINTF_RE = re.compile(r"%[-+ 0#]*\d*(?:\.\d+)?(?:hh|h|ll|l|z)?([a-zA-Z%])")
+STRFTIME_RE = re.compile(r"%([a-zA-Z%])")
+LITERAL = r'"((?:[^"\\]|\\.)*)"'
+CALL_RE = re.compile(r"\b(lv_label_set_text|snprintf|strlcat|strcat|strftime)\s*\(([^;]*)\);")
+DEFINE_RE = re.compile(r"#define\s+(\w+)\s+" + LITERAL)
+TABLE_RE = re.compile(r"\{\s*(\w+)\s*,\s*" + LITERAL + r"\s*\}")
+
+
+def c_string(body):
+    """Decodes a C string literal body into the text it stores (UTF-8)."""
+    raw = bytearray()
+    i = 0
+    while i < len(body):
+        if body[i] == "\\":
+            nxt = body[i + 1]
+            if nxt == "x":
+                digits = re.match(r"[0-9a-fA-F]+", body[i + 2:]).group(0)
+                raw.append(int(digits, 16))
+                i += 2 + len(digits)
+                continue
+            raw += {"n": b"\n", "t": b"\t", "0": b"\0"}.get(nxt, nxt.encode())
+            i += 2
+            continue
+        raw += body[i].encode()
+        i += 1
+    return raw.decode("utf-8")
+
+
+def rendered_chars():
+    """Returns {char: where it comes from} for everything the UI can draw."""
+    needed = {}
+
+    def add(chars, where):
+        for ch in chars:
+            if ch not in "\n\0":
+                needed.setdefault(ch, where)
+
+    for rel in UI_SOURCES:
+        with open(os.path.join(ROOT, rel)) as src:
+            text = re.sub(r"//[^\n]*|/\*.*?\*/", "", src.read(), flags=re.S)
+        macros = {name: c_string(body) for name, body in DEFINE_RE.findall(text)}
+        for macro, name in TABLE_RE.findall(text):  # WeatherData rows
+            add(macros.get(macro, ""), rel + ":" + macro)
+            add(c_string(name), rel + ":" + name)
+        for func, args in CALL_RE.findall(text):
+            literals = [c_string(lit) for lit in re.findall(LITERAL, args)]
+            for name in re.findall(r"\b\w+\b", re.sub(LITERAL, "", args)):
+                if name in macros:
+                    literals.append(macros[name])
+            for lit in literals:
+                spec_re, spec_chars = (STRFTIME_RE, STRFTIME_CHARS) if func == "strftime" else (PRINTF_RE, PRINTF_CHARS)
+                for conv in spec_re.findall(lit):
+                    if conv == "s":
+                        add("".join(DAY_NAMES), rel + ":%s")
+                    elif conv not in spec_chars:
+                        raise ValueError("%s: unknown conversion %%%s in %r" % (rel, conv, lit))
+                    else:
+                        add(spec_chars[conv], rel + ":" + lit)
+                add(spec_re.sub("", lit), rel + ":" + lit)
+    return needed
+
+
+def codepoints(font):
+    """Maps each codepoint of a parsed font to its glyph id."""
+    ids = {}
+    for cmap in font["cmaps"]:
+        if cmap["list"]:
+            for i, ofs in enumerate(cmap["list"]):
+                ids[cmap["start"] + ofs] = cmap["gid"] + i
+        else:
+            for i in range(cmap["length"]):
+                ids[cmap["start"] + i] = cmap["gid"] + i
+    return ids
+
+
+def glyph_bytes(font, gid):
+    index, _, box_w, box_h, _, _ = font["glyphs"][gid]
+    return font["bitmap"][index:index + (box_w * box_h * font["bpp"] + 7) // 8]
+
+
+def hex_rows(data, indent="    "):
+    rows = []
+    for i in range(0, len(data), 8):
+        rows.append(indent + ", ".join("0x%x" % b for b in data[i:i + 8]))
+    return ",\n".join(rows)
+
+
+def char_comment(cp):
+    ch = chr(cp)
+    if ch == '"' or ch == "\\":
+        ch = "\\" + ch
+    return '/* U+%04X "%s" */' % (cp, ch)
+
+
+def subset_source(src_text, font, keep):
+    """Rewrites the tables of an lv_font_conv source to only hold the codepoints in keep."""
+    ids = codepoints(font)
+    blocks = []
+    glyph_rows = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */"]
+    index = 0
+    for cp in keep:
+        data = glyph_bytes(font, ids[cp])
+        _, adv_w, box_w, box_h, ofs_x, ofs_y = font["glyphs"][ids[cp]]
+        blocks.append((char_comment(cp), data))
+        glyph_rows.append("    {.bitmap_index = %d, .adv_w = %d, .box_w = %d, .box_h = %d, .ofs_x = %d, .ofs_y = %d}"
+                          % (index, adv_w, box_w, box_h, ofs_x, ofs_y))
+        index += len(data)
+
+    last = max(i for i, (_, data) in enumerate(blocks) if data)
+    bitmap_blocks = []
+    for i, (comment, data) in enumerate(blocks):
+        rows = ("\n" + hex_rows(data) + ("," if i != last else "")) if data else ""
+        bitmap_blocks.append("    " + comment + rows)
+    bitmap = "static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {\n" + "\n\n".join(bitmap_blocks) + "\n};"
+    glyphs = "static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n" + ",\n".join(glyph_rows) + "\n};"
+    offsets = [cp - keep[0] for cp in keep]
+    mapping = ("/*---------------------\n *  CHARACTER MAPPING\n *--------------------*/\n\n"
+               "static const uint16_t unicode_list_0[] = {\n" +
+               ",\n".join("    " + ", ".join("0x%x" % o for o in offsets[i:i + 8]) for i in range(0, len(offsets), 8)) +
+               "\n};\n\n/*Collect the unicode lists and glyph_id offsets*/\n"
+               "static const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n    {\n"
+               "        .range_start = %d, .range_length = %d, .glyph_id_start = 1,\n"
+               "        .unicode_list = unicode_list_0, .glyph_id_ofs_list = NULL, .list_length = %d, "
+               ".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY\n    }\n};\n\n\n\n"
+               % (keep[0], keep[-1] - keep[0] + 1, len(keep)))
+
+    text = re.sub(r"static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap\[\] = \{.*?\n\};",
+                  lambda _: bitmap, src_text, count=1, flags=re.S)
+    text = re.sub(r"static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc\[\] = \{.*?\n\};",
+                  lambda _: glyphs, text, count=1, flags=re.S)
+    text = re.sub(r"/\*-+\n \*  CHARACTER MAPPING.*?(?=/\*-+\n \*  ALL CUSTOM DATA)",
+                  lambda _: mapping, text, count=1, flags=re.S)
+    text = re.sub(r"\.cmap_num = \d+", ".cmap_num = 1", text, count=1)
+    return text.replace(" * Opts: ", " * Subset: %d glyphs kept by tools/font_subset.py\n * Opts: " % len(keep), 1)
+
+
+def table_bytes(font):
+    """Flash taken by the bitmap, glyph descriptors and unicode lists."""
+    return len(font["bitmap"]) + 8 * len(font["glyphs"]) + sum(2 * len(c["list"]) for c in font["cmaps"])
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--check", action="store_true", help="only verify the subsets in main/fonts")
+    args = parser.parse_args()
+
+    needed = rendered_chars()
+    full_fonts = [(full, out, parse_font(os.path.join(ROOT, full))) for full, out in FONTS]
+    missing = [ch for ch in needed if not any(ord(ch) in codepoints(font) for _, _, font in full_fonts)]
+    for ch in missing:
+        print("missing glyph U+%04X %r needed by %s" % (ord(ch), ch, needed[ch]))
+    if missing:
+        return 1
+
+    failed = False
+    saved = 0
+    for full, out, font in full_fonts:
+        keep = sorted(ord(ch) for ch in needed if ord(ch) in codepoints(font))
+        path = os.path.join(ROOT, out)
+        if args.check:
+            present = codepoints(parse_font(path)) if os.path.exists(path) else {}
+            lacking = [cp for cp in keep if cp not in present]
+            for cp in lacking:
+                print("%s lacks U+%04X, rerun tools/font_subset.py" % (out, cp))
+            failed = failed or bool(lacking)
+            continue
+        with open(os.path.join(ROOT, full)) as src:
+            text = subset_source(src.read(), font, keep)
+        with open(path, "w") as dst:
+            dst.write(text)
+        before = table_bytes(font)
+        after = table_bytes(parse_font(path))
+        saved += before - after
+        print("%s: %d of %d glyphs, %d -> %d bytes" % (out, len(keep), len(font["glyphs"]) - 1, before, after))
+    if not args.check:
+        print("flash saved: %d bytes" % saved)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
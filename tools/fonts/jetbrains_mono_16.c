@@ -0,0 +1,886 @@
+/*******************************************************************************
+ * Size: 15 px
+ * Bpp: 4
+ * Opts: --bpp 4 --size 15 --no-compress --font JetBrainsMonoNL-Regular.ttf --range 32-122,176 --format lvgl -o jetbrains_mono_16.c
+ ******************************************************************************/
+
+#ifdef LV_LVGL_H_INCLUDE_SIMPLE
+#include "lvgl.h"
+#else
+#include "lvgl.h"
+#endif
+
+#ifndef JETBRAINS_MONO_16
+#define JETBRAINS_MONO_16 1
+#endif
+
+#if JETBRAINS_MONO_16
+
+/*-----------------
+ *    BITMAPS
+ *----------------*/
+
+/*Store the image of the glyphs*/
+static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {
+    /* U+0020 " " */
+
+    /* U+0021 "!" */
+    0x4f, 0x44, 0xf4, 0x3f, 0x33, 0xf3, 0x3f, 0x32,
+    0xf2, 0x2f, 0x22, 0xf2, 0x4, 0x0, 0x0, 0x5e,
+    0x66, 0xf6,
+
+    /* U+0022 "\"" */
+    0xda, 0xa, 0xdd, 0xa0, 0xad, 0xc9, 0x9, 0xcc,
+    0x90, 0x9c, 0x97, 0x7, 0x90,
+
+    /* U+0023 "#" */
+    0x0, 0xd, 0x30, 0x5a, 0x0, 0x0, 0xf1, 0x8,
+    0x80, 0x0, 0x1f, 0x0, 0xa6, 0x0, 0x3, 0xc0,
+    0xc, 0x40, 0xe, 0xff, 0xee, 0xfe, 0x60, 0x19,
+    0x81, 0x3e, 0x10, 0x0, 0xb5, 0x4, 0xc0, 0x0,
+    0xe, 0x20, 0x79, 0x0, 0x6e, 0xfe, 0xef, 0xfe,
+    0x0, 0x5c, 0x11, 0xd5, 0x10, 0x7, 0x90, 0xf,
+    0x0, 0x0, 0xa6, 0x3, 0xd0, 0x0,
+
+    /* U+0024 "$" */
+    0x0, 0xe, 0x0, 0x0, 0x0, 0xe0, 0x0, 0x5,
+    0xcf, 0xd6, 0x3, 0xf8, 0xe7, 0xf5, 0x8c, 0xe,
+    0xa, 0xb8, 0xd0, 0xe0, 0x0, 0x3f, 0x9e, 0x0,
+    0x0, 0x6f, 0xfb, 0x30, 0x0, 0x1e, 0xcf, 0x30,
+    0x0, 0xe0, 0xcb, 0x73, 0xe, 0x7, 0xeb, 0xb0,
+    0xe0, 0xac, 0x4f, 0xcf, 0xbf, 0x40, 0x3a, 0xfb,
+    0x40, 0x0, 0xe, 0x0, 0x0, 0x0, 0xe0, 0x0,
+
+    /* U+0025 "%" */
+    0x2d, 0xf9, 0x0, 0xa, 0x7a, 0x92, 0xe4, 0x4,
+    0xd0, 0xc5, 0xb, 0x60, 0xd3, 0xb, 0x70, 0xd5,
+    0x79, 0x0, 0x4f, 0xfc, 0x2e, 0x10, 0x0, 0x1,
+    0xb, 0x50, 0x0, 0x0, 0x5, 0xb0, 0x0, 0x0,
+    0x1, 0xe2, 0x9e, 0xc2, 0x0, 0x97, 0x4e, 0x39,
+    0xa0, 0x3d, 0x6, 0xb0, 0x5c, 0xd, 0x40, 0x4d,
+    0x28, 0xb7, 0x90, 0x0, 0xaf, 0xd3,
+
+    /* U+0026 "&" */
+    0x0, 0x5d, 0xfa, 0x10, 0x0, 0x2, 0xf8, 0x5d,
+    0xa0, 0x0, 0x4, 0xf0, 0x6, 0xf0, 0x0, 0x1,
+    0xf4, 0x0, 0x0, 0x0, 0x0, 0x8e, 0x10, 0x0,
+    0x0, 0x7, 0xef, 0xa0, 0x0, 0x0, 0x4f, 0x63,
+    0xf6, 0xb, 0xc0, 0x9c, 0x0, 0x5f, 0x9e, 0x10,
+    0x9b, 0x0, 0xa, 0xf4, 0x0, 0x8c, 0x0, 0x1e,
+    0xf8, 0x0, 0x3f, 0x85, 0xdb, 0x4f, 0x30, 0x6,
+    0xdf, 0xa0, 0x9, 0xd0,
+
+    /* U+0027 "'" */
+    0x4f, 0x43, 0xf3, 0x3f, 0x32, 0xf2, 0x1d, 0x20,
+
+    /* U+0028 "(" */
+    0x0, 0x0, 0x31, 0x0, 0x1b, 0xf4, 0x0, 0xdd,
+    0x30, 0x8, 0xf1, 0x0, 0xe, 0x80, 0x0, 0x1f,
+    0x40, 0x0, 0x3f, 0x20, 0x0, 0x3f, 0x20, 0x0,
+    0x3f, 0x20, 0x0, 0x3f, 0x20, 0x0, 0x2f, 0x30,
+    0x0, 0xf, 0x60, 0x0, 0xb, 0xc0, 0x0, 0x3,
+    0xf8, 0x0, 0x0, 0x6f, 0xc2, 0x0, 0x3, 0xa3,
+
+    /* U+0029 ")" */
+    0x13, 0x0, 0x0, 0x4f, 0xb1, 0x0, 0x3, 0xdd,
+    0x0, 0x0, 0x1f, 0x80, 0x0, 0x8, 0xe0, 0x0,
+    0x4, 0xf1, 0x0, 0x2, 0xf3, 0x0, 0x2, 0xf3,
+    0x0, 0x2, 0xf3, 0x0, 0x2, 0xf3, 0x0, 0x3,
+    0xf2, 0x0, 0x6, 0xf0, 0x0, 0xc, 0xb0, 0x0,
+    0x8f, 0x30, 0x2c, 0xf6, 0x0, 0x3a, 0x30, 0x0,
+
+    /* U+002A "*" */
+    0x0, 0x2, 0xf2, 0x0, 0x0, 0x0, 0x2f, 0x20,
+    0x0, 0x28, 0x21, 0xf1, 0x28, 0x23, 0xef, 0xaf,
+    0xaf, 0xd3, 0x0, 0x4b, 0xfb, 0x40, 0x0, 0x1,
+    0xea, 0xe1, 0x0, 0x0, 0xbc, 0xc, 0xb0, 0x0,
+    0x2f, 0x30, 0x3f, 0x20, 0x0, 0x10, 0x0, 0x10,
+    0x0,
+
+    /* U+002B "+" */
+    0x0, 0x2, 0xf2, 0x0, 0x0, 0x0, 0x2f, 0x20,
+    0x0, 0x0, 0x3, 0xf3, 0x0, 0x0, 0xff, 0xff,
+    0xff, 0xf0, 0x3, 0x35, 0xf5, 0x33, 0x0, 0x0,
+    0x2f, 0x20, 0x0, 0x0, 0x2, 0xf2, 0x0, 0x0,
+    0x0, 0x18, 0x10, 0x0,
+
+    /* U+002C "," */
+    0x1e, 0x74, 0xf4, 0x6f, 0x19, 0xd0, 0xca, 0x0,
+
+    /* U+002D "-" */
+    0x0, 0x0, 0xe, 0xff, 0xfe, 0x33, 0x33, 0x30,
+
+    /* U+002E "." */
+    0x28, 0x2a, 0xfa, 0x6f, 0x60,
+
+    /* U+002F "/" */
+    0x0, 0x0, 0xb, 0xb0, 0x0, 0x1, 0xf5, 0x0,
+    0x0, 0x6f, 0x0, 0x0, 0xc, 0xa0, 0x0, 0x2,
+    0xf4, 0x0, 0x0, 0x8e, 0x0, 0x0, 0xd, 0x90,
+    0x0, 0x3, 0xf3, 0x0, 0x0, 0x9d, 0x0, 0x0,
+    0xe, 0x70, 0x0, 0x4, 0xf2, 0x0, 0x0, 0xac,
+    0x0, 0x0, 0xf, 0x60, 0x0, 0x5, 0xf1, 0x0,
+    0x0, 0xbb, 0x0, 0x0, 0x0,
+
+    /* U+0030 "0" */
+    0x5, 0xdf, 0xd5, 0x3, 0xf9, 0x49, 0xf3, 0xab,
+    0x0, 0xb, 0xac, 0x80, 0x0, 0x8c, 0xc8, 0x0,
+    0x8, 0xcc, 0x83, 0xe3, 0x8c, 0xc8, 0x2b, 0x28,
+    0xcc, 0x80, 0x0, 0x8c, 0xc8, 0x0, 0x8, 0xca,
+    0xb0, 0x0, 0xba, 0x4f, 0x84, 0x8f, 0x40, 0x5d,
+    0xfd, 0x50,
+
+    /* U+0031 "1" */
+    0x1, 0xbf, 0xa0, 0x0, 0x2d, 0xdd, 0xa0, 0x0,
+    0xac, 0x1b, 0xa0, 0x0, 0x40, 0xb, 0xa0, 0x0,
+    0x0, 0xb, 0xa0, 0x0, 0x0, 0xb, 0xa0, 0x0,
+    0x0, 0xb, 0xa0, 0x0, 0x0, 0xb, 0xa0, 0x0,
+    0x0, 0xb, 0xa0, 0x0, 0x0, 0xb, 0xa0, 0x0,
+    0x35, 0x5c, 0xc5, 0x50, 0xaf, 0xff, 0xff, 0xf1,
+
+    /* U+0032 "2" */
+    0x5, 0xdf, 0xd4, 0x4, 0xf9, 0x5a, 0xf3, 0xab,
+    0x0, 0xc, 0x96, 0x40, 0x0, 0xab, 0x0, 0x0,
+    0xd, 0x90, 0x0, 0x5, 0xf3, 0x0, 0x2, 0xf8,
+    0x0, 0x1, 0xeb, 0x0, 0x0, 0xcc, 0x0, 0x0,
+    0xbd, 0x10, 0x0, 0x8f, 0x75, 0x55, 0x4b, 0xff,
+    0xff, 0xfe,
+
+    /* U+0033 "3" */
+    0xaf, 0xff, 0xff, 0x63, 0x55, 0x5a, 0xf3, 0x0,
+    0x3, 0xf6, 0x0, 0x2, 0xe8, 0x0, 0x0, 0xcf,
+    0x60, 0x0, 0x8, 0xbf, 0xd0, 0x0, 0x0, 0x2f,
+    0x60, 0x0, 0x0, 0xc9, 0x52, 0x0, 0xb, 0xad,
+    0x90, 0x0, 0xe8, 0x7f, 0x85, 0xaf, 0x20, 0x7d,
+    0xfc, 0x40,
+
+    /* U+0034 "4" */
+    0x0, 0x3, 0xf4, 0x0, 0x0, 0xcb, 0x0, 0x0,
+    0x5f, 0x20, 0x0, 0xe, 0x90, 0x0, 0x8, 0xe1,
+    0x0, 0x1, 0xf7, 0x0, 0xc4, 0xad, 0x0, 0xf,
+    0x5f, 0x71, 0x11, 0xf5, 0xff, 0xff, 0xff, 0x53,
+    0x44, 0x44, 0xf5, 0x0, 0x0, 0xf, 0x50, 0x0,
+    0x0, 0xf5,
+
+    /* U+0035 "5" */
+    0x8f, 0xff, 0xff, 0x58, 0xd5, 0x55, 0x51, 0x8c,
+    0x0, 0x0, 0x8, 0xc0, 0x0, 0x0, 0x8c, 0x10,
+    0x0, 0x8, 0xff, 0xfe, 0x70, 0x24, 0x44, 0x8f,
+    0x50, 0x0, 0x0, 0xc9, 0x21, 0x0, 0xa, 0xbc,
+    0x90, 0x0, 0xc9, 0x6f, 0x85, 0x9f, 0x40, 0x7d,
+    0xfd, 0x50,
+
+    /* U+0036 "6" */
+    0x0, 0x0, 0xcc, 0x0, 0x0, 0x0, 0x4f, 0x40,
+    0x0, 0x0, 0xc, 0xc0, 0x0, 0x0, 0x4, 0xf4,
+    0x0, 0x0, 0x0, 0xdc, 0x0, 0x0, 0x0, 0x4f,
+    0xce, 0xd7, 0x0, 0xb, 0xf6, 0x36, 0xf7, 0x0,
+    0xf8, 0x0, 0x8, 0xe0, 0xf, 0x50, 0x0, 0x5f,
+    0x0, 0xd9, 0x0, 0x9, 0xe0, 0x5, 0xf8, 0x58,
+    0xf6, 0x0, 0x6, 0xdf, 0xd6, 0x0,
+
+    /* U+0037 "7" */
+    0xcf, 0xff, 0xff, 0xf3, 0xcb, 0x55, 0x59, 0xf1,
+    0xc9, 0x0, 0xa, 0xc0, 0x32, 0x0, 0x1f, 0x60,
+    0x0, 0x0, 0x6f, 0x10, 0x0, 0x0, 0xca, 0x0,
+    0x0, 0x2, 0xf4, 0x0, 0x0, 0x8, 0xe0, 0x0,
+    0x0, 0xd, 0x90, 0x0, 0x0, 0x3f, 0x30, 0x0,
+    0x0, 0x9d, 0x0, 0x0, 0x0, 0xf7, 0x0, 0x0,
+
+    /* U+0038 "8" */
+    0x0, 0x5d, 0xfd, 0x50, 0x0, 0x4f, 0x95, 0x9f,
+    0x40, 0xa, 0xc0, 0x0, 0xca, 0x0, 0xab, 0x0,
+    0xb, 0xa0, 0x3, 0xf5, 0x15, 0xf3, 0x0, 0x6,
+    0xff, 0xf6, 0x0, 0x5, 0xf8, 0x48, 0xf5, 0x0,
+    0xd9, 0x0, 0x9, 0xd0, 0xf, 0x60, 0x0, 0x6f,
+    0x0, 0xd9, 0x0, 0x9, 0xd0, 0x6, 0xf9, 0x59,
+    0xf6, 0x0, 0x6, 0xdf, 0xd6, 0x0,
+
+    /* U+0039 "9" */
+    0x0, 0x6d, 0xfd, 0x50, 0x0, 0x6f, 0x95, 0x9f,
+    0x50, 0xd, 0x90, 0x0, 0x9d, 0x0, 0xf5, 0x0,
+    0x5, 0xf0, 0xf, 0x70, 0x0, 0x7f, 0x0, 0x9e,
+    0x40, 0x4e, 0xb0, 0x0, 0xbf, 0xfe, 0xf4, 0x0,
+    0x0, 0x11, 0xcd, 0x0, 0x0, 0x0, 0x5f, 0x40,
+    0x0, 0x0, 0xd, 0xc0, 0x0, 0x0, 0x5, 0xf4,
+    0x0, 0x0, 0x0, 0xdc, 0x0, 0x0,
+
+    /* U+003A ":" */
+    0x7f, 0x7a, 0xfa, 0x15, 0x10, 0x0, 0x0, 0x0,
+    0x0, 0x15, 0x1a, 0xfa, 0x7f, 0x70,
+
+    /* U+003B ";" */
+    0x7f, 0x7b, 0xfb, 0x16, 0x10, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x2, 0xe6, 0x5f, 0x38, 0xf0, 0xac,
+    0xd, 0x90,
+
+    /* U+003C "<" */
+    0x0, 0x0, 0x0, 0x40, 0x0, 0x5, 0xeb, 0x0,
+    0x4d, 0xf7, 0x3, 0xcf, 0x81, 0x0, 0xbb, 0x10,
+    0x0, 0x7, 0xfb, 0x30, 0x0, 0x2, 0xbf, 0xa2,
+    0x0, 0x0, 0x3c, 0xf7, 0x0, 0x0, 0x4, 0x80,
+
+    /* U+003D "=" */
+    0x0, 0x0, 0x0, 0xb, 0xff, 0xff, 0xfb, 0x23,
+    0x33, 0x33, 0x20, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0xb, 0xff, 0xff, 0xfb, 0x23, 0x33, 0x33,
+    0x20,
+
+    /* U+003E ">" */
+    0x40, 0x0, 0x0, 0xb, 0xe5, 0x0, 0x0, 0x18,
+    0xfd, 0x40, 0x0, 0x1, 0x9f, 0xc3, 0x0, 0x0,
+    0x2b, 0xb0, 0x0, 0x2a, 0xf7, 0x1, 0x9f, 0xb2,
+    0x7, 0xfc, 0x30, 0x0, 0x84, 0x0, 0x0, 0x0,
+
+    /* U+003F "?" */
+    0xf, 0xfe, 0x90, 0x0, 0x55, 0x8f, 0xa0, 0x0,
+    0x0, 0x5f, 0x10, 0x0, 0x1, 0xf4, 0x0, 0x0,
+    0x3f, 0x30, 0x0, 0x2c, 0xd0, 0x0, 0xef, 0xe3,
+    0x0, 0xe, 0x80, 0x0, 0x0, 0x84, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x2, 0xe9, 0x0, 0x0, 0x3f,
+    0xa0, 0x0,
+
+    /* U+0040 "@" */
+    0x0, 0x5d, 0xfe, 0x90, 0x0, 0x6f, 0x72, 0x4c,
+    0xa0, 0xe, 0x60, 0x0, 0x1f, 0x23, 0xf0, 0x0,
+    0x0, 0xd5, 0x5e, 0x0, 0x9f, 0xbd, 0x65, 0xe0,
+    0x3f, 0x22, 0xf6, 0x5e, 0x6, 0xd0, 0xd, 0x65,
+    0xe0, 0x6c, 0x0, 0xc6, 0x5e, 0x6, 0xc0, 0xd,
+    0x65, 0xe0, 0x3f, 0x22, 0xf3, 0x4e, 0x0, 0x8f,
+    0xf8, 0x3, 0xf0, 0x0, 0x0, 0x0, 0xe, 0x70,
+    0x0, 0x0, 0x0, 0x5f, 0x94, 0x31, 0x0, 0x0,
+    0x4c, 0xff, 0x80, 0x0,
+
+    /* U+0041 "A" */
+    0x0, 0x8, 0xf8, 0x0, 0x0, 0x0, 0xce, 0xc0,
+    0x0, 0x0, 0xf, 0x8f, 0x0, 0x0, 0x3, 0xf2,
+    0xf3, 0x0, 0x0, 0x7d, 0xd, 0x70, 0x0, 0xb,
+    0xa0, 0xab, 0x0, 0x0, 0xf7, 0x7, 0xf0, 0x0,
+    0x2f, 0x30, 0x3f, 0x30, 0x6, 0xff, 0xff, 0xf6,
+    0x0, 0xac, 0x33, 0x3c, 0xa0, 0xe, 0x80, 0x0,
+    0x7e, 0x2, 0xf4, 0x0, 0x3, 0xf2,
+
+    /* U+0042 "B" */
+    0x9f, 0xff, 0xd6, 0x9, 0xc4, 0x59, 0xf4, 0x9b,
+    0x0, 0xc, 0x99, 0xb0, 0x0, 0xb9, 0x9b, 0x0,
+    0x5f, 0x39, 0xff, 0xff, 0x50, 0x9c, 0x33, 0x7f,
+    0x39, 0xb0, 0x0, 0x9c, 0x9b, 0x0, 0x6, 0xe9,
+    0xb0, 0x0, 0x9c, 0x9c, 0x44, 0x8f, 0x69, 0xff,
+    0xfd, 0x70,
+
+    /* U+0043 "C" */
+    0x4, 0xcf, 0xd6, 0x2, 0xfb, 0x58, 0xf5, 0x7e,
+    0x0, 0xb, 0xb9, 0xb0, 0x0, 0x34, 0xab, 0x0,
+    0x0, 0xa, 0xb0, 0x0, 0x0, 0xab, 0x0, 0x0,
+    0xa, 0xb0, 0x0, 0x0, 0x9b, 0x0, 0x3, 0x47,
+    0xe0, 0x0, 0xbb, 0x2f, 0xa5, 0x8f, 0x50, 0x4c,
+    0xfd, 0x60,
+
+    /* U+0044 "D" */
+    0xaf, 0xff, 0xc3, 0xa, 0xc4, 0x5b, 0xf2, 0xab,
+    0x0, 0xe, 0x8a, 0xb0, 0x0, 0xba, 0xab, 0x0,
+    0xa, 0xba, 0xb0, 0x0, 0xab, 0xab, 0x0, 0xa,
+    0xba, 0xb0, 0x0, 0xab, 0xab, 0x0, 0xb, 0xaa,
+    0xb0, 0x0, 0xe8, 0xac, 0x45, 0xbf, 0x2a, 0xff,
+    0xfc, 0x30,
+
+    /* U+0045 "E" */
+    0x8f, 0xff, 0xff, 0xc8, 0xe5, 0x55, 0x53, 0x8d,
+    0x0, 0x0, 0x8, 0xd0, 0x0, 0x0, 0x8d, 0x0,
+    0x0, 0x8, 0xff, 0xff, 0xf4, 0x8d, 0x33, 0x33,
+    0x18, 0xd0, 0x0, 0x0, 0x8d, 0x0, 0x0, 0x8,
+    0xd0, 0x0, 0x0, 0x8e, 0x55, 0x55, 0x38, 0xff,
+    0xff, 0xfc,
+
+    /* U+0046 "F" */
+    0x9f, 0xff, 0xff, 0xe9, 0xd5, 0x55, 0x54, 0x9c,
+    0x0, 0x0, 0x9, 0xc0, 0x0, 0x0, 0x9c, 0x0,
+    0x0, 0x9, 0xc1, 0x11, 0x10, 0x9f, 0xff, 0xff,
+    0x79, 0xd4, 0x44, 0x41, 0x9c, 0x0, 0x0, 0x9,
+    0xc0, 0x0, 0x0, 0x9c, 0x0, 0x0, 0x9, 0xc0,
+    0x0, 0x0,
+
+    /* U+0047 "G" */
+    0x4, 0xcf, 0xd5, 0x3, 0xfa, 0x59, 0xf3, 0x8d,
+    0x0, 0xc, 0x9a, 0xa0, 0x0, 0x45, 0xba, 0x0,
+    0x0, 0xb, 0xa0, 0x1, 0x10, 0xba, 0xc, 0xff,
+    0xcb, 0xa0, 0x34, 0xac, 0xaa, 0x0, 0x9, 0xc8,
+    0xd0, 0x0, 0xba, 0x3f, 0xa5, 0x8f, 0x40, 0x4d,
+    0xfd, 0x50,
+
+    /* U+0048 "H" */
+    0x9c, 0x0, 0xc, 0x99, 0xc0, 0x0, 0xc9, 0x9c,
+    0x0, 0xc, 0x99, 0xc0, 0x0, 0xc9, 0x9c, 0x11,
+    0x1c, 0x99, 0xff, 0xff, 0xf9, 0x9d, 0x44, 0x4d,
+    0x99, 0xc0, 0x0, 0xc9, 0x9c, 0x0, 0xc, 0x99,
+    0xc0, 0x0, 0xc9, 0x9c, 0x0, 0xc, 0x99, 0xc0,
+    0x0, 0xc9,
+
+    /* U+0049 "I" */
+    0x6f, 0xff, 0xff, 0x62, 0x57, 0xf7, 0x52, 0x0,
+    0x3f, 0x30, 0x0, 0x3, 0xf3, 0x0, 0x0, 0x3f,
+    0x30, 0x0, 0x3, 0xf3, 0x0, 0x0, 0x3f, 0x30,
+    0x0, 0x3, 0xf3, 0x0, 0x0, 0x3f, 0x30, 0x0,
+    0x3, 0xf3, 0x0, 0x25, 0x7f, 0x75, 0x26, 0xff,
+    0xff, 0xf6,
+
+    /* U+004A "J" */
+    0x0, 0x0, 0x0, 0xe6, 0x0, 0x0, 0x0, 0xe6,
+    0x0, 0x0, 0x0, 0xe6, 0x0, 0x0, 0x0, 0xe6,
+    0x0, 0x0, 0x0, 0xe6, 0x0, 0x0, 0x0, 0xe6,
+    0x0, 0x0, 0x0, 0xe6, 0x0, 0x0, 0x0, 0xe6,
+    0x29, 0x0, 0x0, 0xf6, 0x2f, 0x30, 0x2, 0xf4,
+    0xc, 0xd6, 0x5d, 0xd0, 0x1, 0xae, 0xea, 0x10,
+
+    /* U+004B "K" */
+    0xab, 0x0, 0x7, 0xf1, 0xab, 0x0, 0xe, 0x80,
+    0xab, 0x0, 0x7f, 0x10, 0xab, 0x0, 0xe8, 0x0,
+    0xab, 0x7, 0xf1, 0x0, 0xaf, 0xff, 0xa0, 0x0,
+    0xac, 0x3a, 0xe0, 0x0, 0xab, 0x2, 0xf6, 0x0,
+    0xab, 0x0, 0xbd, 0x0, 0xab, 0x0, 0x3f, 0x40,
+    0xab, 0x0, 0xc, 0xb0, 0xab, 0x0, 0x5, 0xf2,
+
+    /* U+004C "L" */
+    0xf, 0x40, 0x0, 0x0, 0xf, 0x40, 0x0, 0x0,
+    0xf, 0x40, 0x0, 0x0, 0xf, 0x40, 0x0, 0x0,
+    0xf, 0x40, 0x0, 0x0, 0xf, 0x40, 0x0, 0x0,
+    0xf, 0x40, 0x0, 0x0, 0xf, 0x40, 0x0, 0x0,
+    0xf, 0x40, 0x0, 0x0, 0xf, 0x40, 0x0, 0x0,
+    0xf, 0x85, 0x55, 0x51, 0xf, 0xff, 0xff, 0xf4,
+
+    /* U+004D "M" */
+    0xef, 0x30, 0x3f, 0xee, 0xc7, 0x8, 0xce, 0xe9,
+    0xb0, 0xc8, 0xee, 0x6f, 0x1e, 0x5e, 0xe5, 0xb9,
+    0xa5, 0xee, 0x67, 0xf5, 0x6e, 0xe6, 0x2a, 0x16,
+    0xee, 0x60, 0x0, 0x6e, 0xe6, 0x0, 0x6, 0xee,
+    0x60, 0x0, 0x6e, 0xe6, 0x0, 0x6, 0xee, 0x60,
+    0x0, 0x6e,
+
+    /* U+004E "N" */
+    0xaf, 0x50, 0xa, 0xaa, 0xfa, 0x0, 0xaa, 0xac,
+    0xf0, 0xa, 0xaa, 0x9e, 0x40, 0xaa, 0xaa, 0x99,
+    0xa, 0xaa, 0xa4, 0xe0, 0xaa, 0xaa, 0xe, 0x4a,
+    0xaa, 0xa0, 0x99, 0xaa, 0xaa, 0x4, 0xea, 0xaa,
+    0xa0, 0xf, 0xca, 0xaa, 0x0, 0xaf, 0xaa, 0xa0,
+    0x5, 0xfa,
+
+    /* U+004F "O" */
+    0x4, 0xdf, 0xd4, 0x2, 0xfa, 0x5a, 0xf2, 0x8d,
+    0x0, 0xd, 0x8a, 0xa0, 0x0, 0xaa, 0xba, 0x0,
+    0xa, 0xbb, 0xa0, 0x0, 0xab, 0xba, 0x0, 0xa,
+    0xbb, 0xa0, 0x0, 0xab, 0xaa, 0x0, 0xa, 0xa8,
+    0xd0, 0x0, 0xd8, 0x2f, 0x95, 0x9f, 0x20, 0x4d,
+    0xfd, 0x40,
+
+    /* U+0050 "P" */
+    0xaf, 0xff, 0xe9, 0x0, 0xad, 0x44, 0x6e, 0xa0,
+    0xab, 0x0, 0x6, 0xf1, 0xab, 0x0, 0x2, 0xf3,
+    0xab, 0x0, 0x4, 0xf1, 0xac, 0x11, 0x3d, 0xc0,
+    0xaf, 0xff, 0xfd, 0x20, 0xac, 0x43, 0x20, 0x0,
+    0xab, 0x0, 0x0, 0x0, 0xab, 0x0, 0x0, 0x0,
+    0xab, 0x0, 0x0, 0x0, 0xab, 0x0, 0x0, 0x0,
+
+    /* U+0051 "Q" */
+    0x5, 0xdf, 0xd5, 0x3, 0xf9, 0x59, 0xf4, 0xac,
+    0x0, 0xc, 0xac, 0x80, 0x0, 0x8c, 0xc8, 0x0,
+    0x8, 0xcc, 0x80, 0x0, 0x8c, 0xc8, 0x0, 0x8,
+    0xcc, 0x80, 0x0, 0x8c, 0xc8, 0x0, 0x8, 0xca,
+    0xc0, 0x0, 0xca, 0x4f, 0x95, 0x9f, 0x40, 0x5d,
+    0xff, 0x70, 0x0, 0x0, 0xe9, 0x0, 0x0, 0x7,
+    0xf2, 0x0, 0x0, 0xe, 0xa0,
+
+    /* U+0052 "R" */
+    0x9f, 0xff, 0xe7, 0x0, 0x9d, 0x44, 0x8f, 0x70,
+    0x9b, 0x0, 0x9, 0xd0, 0x9b, 0x0, 0x6, 0xf0,
+    0x9b, 0x0, 0x8, 0xe0, 0x9b, 0x0, 0x4e, 0x90,
+    0x9f, 0xff, 0xfc, 0x0, 0x9c, 0x37, 0xf2, 0x0,
+    0x9b, 0x0, 0xd9, 0x0, 0x9b, 0x0, 0x6f, 0x10,
+    0x9b, 0x0, 0xe, 0x70, 0x9b, 0x0, 0x8, 0xe0,
+
+    /* U+0053 "S" */
+    0x5, 0xdf, 0xd4, 0x3, 0xf9, 0x5a, 0xf3, 0x9c,
+    0x0, 0xd, 0x89, 0xb0, 0x0, 0x11, 0x5f, 0x60,
+    0x0, 0x0, 0x9f, 0xfa, 0x30, 0x0, 0x27, 0xdf,
+    0x30, 0x0, 0x0, 0xcb, 0x52, 0x0, 0x7, 0xec,
+    0xa0, 0x0, 0x9c, 0x6f, 0x85, 0x8f, 0x60, 0x6d,
+    0xfd, 0x60,
+
+    /* U+0054 "T" */
+    0x2f, 0xff, 0xff, 0xff, 0x20, 0x55, 0x6f, 0x65,
+    0x50, 0x0, 0x2, 0xf2, 0x0, 0x0, 0x0, 0x2f,
+    0x20, 0x0, 0x0, 0x2, 0xf2, 0x0, 0x0, 0x0,
+    0x2f, 0x20, 0x0, 0x0, 0x2, 0xf2, 0x0, 0x0,
+    0x0, 0x2f, 0x20, 0x0, 0x0, 0x2, 0xf2, 0x0,
+    0x0, 0x0, 0x2f, 0x20, 0x0, 0x0, 0x2, 0xf2,
+    0x0, 0x0, 0x0, 0x2f, 0x20, 0x0,
+
+    /* U+0055 "U" */
+    0xab, 0x0, 0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab,
+    0x0, 0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0,
+    0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0, 0xb,
+    0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0, 0xb, 0xa8,
+    0xd0, 0x0, 0xd8, 0x2f, 0x95, 0x9f, 0x30, 0x5d,
+    0xfd, 0x50,
+
+    /* U+0056 "V" */
+    0x2f, 0x30, 0x0, 0x4f, 0x20, 0xe7, 0x0, 0x7,
+    0xe0, 0xa, 0xb0, 0x0, 0xba, 0x0, 0x6e, 0x0,
+    0xe, 0x60, 0x3, 0xf2, 0x2, 0xf3, 0x0, 0xf,
+    0x60, 0x5f, 0x0, 0x0, 0xb9, 0x9, 0xb0, 0x0,
+    0x7, 0xd0, 0xc7, 0x0, 0x0, 0x4f, 0x1f, 0x30,
+    0x0, 0x0, 0xf8, 0xf0, 0x0, 0x0, 0xc, 0xec,
+    0x0, 0x0, 0x0, 0x8f, 0x80, 0x0,
+
+    /* U+0057 "W" */
+    0xa9, 0x4, 0xf5, 0x8, 0xa8, 0xb0, 0x5e, 0x60,
+    0xa8, 0x6c, 0x7, 0xc8, 0xb, 0x65, 0xe0, 0x98,
+    0xa0, 0xd4, 0x3f, 0xb, 0x5c, 0xf, 0x31, 0xf1,
+    0xd1, 0xd0, 0xf1, 0xf, 0x2e, 0xe, 0x2f, 0x0,
+    0xe5, 0xd0, 0xd5, 0xd0, 0xc, 0x9b, 0xb, 0x8b,
+    0x0, 0xac, 0x90, 0x9b, 0xa0, 0x8, 0xf7, 0x7,
+    0xe8, 0x0, 0x7f, 0x50, 0x6f, 0x60,
+
+    /* U+0058 "X" */
+    0xe, 0x90, 0x0, 0x7e, 0x0, 0x7f, 0x10, 0xe,
+    0x70, 0x0, 0xe8, 0x7, 0xe0, 0x0, 0x7, 0xe1,
+    0xe6, 0x0, 0x0, 0xe, 0xce, 0x0, 0x0, 0x0,
+    0x7f, 0x60, 0x0, 0x0, 0x8, 0xf9, 0x0, 0x0,
+    0x1, 0xf9, 0xf2, 0x0, 0x0, 0x9d, 0xd, 0x90,
+    0x0, 0x2f, 0x50, 0x5f, 0x20, 0xa, 0xd0, 0x0,
+    0xda, 0x2, 0xf5, 0x0, 0x6, 0xf2,
+
+    /* U+0059 "Y" */
+    0x4f, 0x20, 0x0, 0x2f, 0x30, 0xc9, 0x0, 0x9,
+    0xc0, 0x6, 0xf1, 0x0, 0xf5, 0x0, 0xe, 0x70,
+    0x6e, 0x0, 0x0, 0x7e, 0xd, 0x70, 0x0, 0x1,
+    0xf9, 0xf1, 0x0, 0x0, 0x9, 0xf9, 0x0, 0x0,
+    0x0, 0x3f, 0x30, 0x0, 0x0, 0x2, 0xf2, 0x0,
+    0x0, 0x0, 0x2f, 0x20, 0x0, 0x0, 0x2, 0xf2,
+    0x0, 0x0, 0x0, 0x2f, 0x20, 0x0,
+
+    /* U+005A "Z" */
+    0xaf, 0xff, 0xff, 0x93, 0x55, 0x55, 0xf7, 0x0,
+    0x0, 0x6f, 0x10, 0x0, 0xe, 0x70, 0x0, 0x7,
+    0xe0, 0x0, 0x1, 0xf6, 0x0, 0x0, 0x8d, 0x0,
+    0x0, 0x1f, 0x50, 0x0, 0x9, 0xc0, 0x0, 0x2,
+    0xf4, 0x0, 0x0, 0xae, 0x55, 0x55, 0x3b, 0xff,
+    0xff, 0xfb,
+
+    /* U+005B "[" */
+    0x0, 0x0, 0xef, 0xfc, 0xe8, 0x32, 0xe6, 0x0,
+    0xe6, 0x0, 0xe6, 0x0, 0xe6, 0x0, 0xe6, 0x0,
+    0xe6, 0x0, 0xe6, 0x0, 0xe6, 0x0, 0xe6, 0x0,
+    0xe6, 0x0, 0xe6, 0x0, 0xe7, 0x0, 0xef, 0xfc,
+    0x33, 0x32,
+
+    /* U+005C "\\" */
+    0xbb, 0x0, 0x0, 0x5, 0xf1, 0x0, 0x0, 0xf,
+    0x60, 0x0, 0x0, 0xac, 0x0, 0x0, 0x4, 0xf2,
+    0x0, 0x0, 0xe, 0x70, 0x0, 0x0, 0x9d, 0x0,
+    0x0, 0x3, 0xf3, 0x0, 0x0, 0xd, 0x90, 0x0,
+    0x0, 0x8e, 0x0, 0x0, 0x2, 0xf4, 0x0, 0x0,
+    0xc, 0xa0, 0x0, 0x0, 0x6f, 0x0, 0x0, 0x1,
+    0xf5, 0x0, 0x0, 0xb, 0xb0,
+
+    /* U+005D "]" */
+    0x0, 0x0, 0xcf, 0xfe, 0x23, 0x8e, 0x0, 0x6e,
+    0x0, 0x6e, 0x0, 0x6e, 0x0, 0x6e, 0x0, 0x6e,
+    0x0, 0x6e, 0x0, 0x6e, 0x0, 0x6e, 0x0, 0x6e,
+    0x0, 0x6e, 0x0, 0x6e, 0x0, 0x7e, 0xcf, 0xfe,
+    0x23, 0x33,
+
+    /* U+005E "^" */
+    0x0, 0x18, 0x10, 0x0, 0x8, 0xf8, 0x0, 0x0,
+    0xe5, 0xe0, 0x0, 0x5d, 0xc, 0x50, 0xc, 0x60,
+    0x6c, 0x2, 0xf0, 0x0, 0xf2, 0x99, 0x0, 0x9,
+    0x90,
+
+    /* U+005F "_" */
+    0x0, 0x0, 0x0, 0x0, 0x1, 0xff, 0xff, 0xff,
+    0xf1, 0x3, 0x33, 0x33, 0x33, 0x0,
+
+    /* U+0060 "`" */
+    0x37, 0x0, 0xd, 0x90, 0x3, 0xf4,
+
+    /* U+0061 "a" */
+    0x7, 0xdf, 0xd6, 0x6, 0xf6, 0x47, 0xf4, 0x11,
+    0x0, 0xc, 0x81, 0xae, 0xff, 0xfa, 0xae, 0x42,
+    0x2c, 0xaf, 0x70, 0x0, 0xba, 0xe7, 0x0, 0xe,
+    0xaa, 0xe5, 0x4b, 0xda, 0x1a, 0xfe, 0x6b, 0xa0,
+
+    /* U+0062 "b" */
+    0xab, 0x0, 0x0, 0xa, 0xb0, 0x0, 0x0, 0xab,
+    0x0, 0x0, 0xa, 0xb7, 0xee, 0x70, 0xae, 0xa4,
+    0x8f, 0x4a, 0xe0, 0x0, 0xc9, 0xab, 0x0, 0xa,
+    0xaa, 0xb0, 0x0, 0xab, 0xab, 0x0, 0xa, 0xaa,
+    0xe0, 0x0, 0xc9, 0xae, 0x94, 0x8f, 0x4a, 0xb7,
+    0xee, 0x70,
+
+    /* U+0063 "c" */
+    0x4, 0xcf, 0xd7, 0x3, 0xfa, 0x58, 0xf6, 0x8d,
+    0x0, 0xa, 0xba, 0xa0, 0x0, 0x0, 0xba, 0x0,
+    0x0, 0xa, 0xa0, 0x0, 0x0, 0x8d, 0x0, 0xa,
+    0xb3, 0xfa, 0x57, 0xf6, 0x4, 0xcf, 0xd7, 0x0,
+
+    /* U+0064 "d" */
+    0x0, 0x0, 0xb, 0xa0, 0x0, 0x0, 0xba, 0x0,
+    0x0, 0xb, 0xa0, 0x7e, 0xe7, 0xba, 0x4f, 0x84,
+    0xae, 0xa9, 0xc0, 0x0, 0xea, 0xaa, 0x0, 0xb,
+    0xab, 0xa0, 0x0, 0xba, 0xaa, 0x0, 0xb, 0xa9,
+    0xc0, 0x0, 0xea, 0x4f, 0x84, 0x9e, 0xa0, 0x7e,
+    0xe7, 0xba,
+
+    /* U+0065 "e" */
+    0x4, 0xcf, 0xd5, 0x3, 0xf8, 0x38, 0xf3, 0x9c,
+    0x0, 0xc, 0x9b, 0x90, 0x0, 0x9b, 0xbf, 0xff,
+    0xff, 0xbb, 0xa2, 0x22, 0x21, 0x9b, 0x0, 0x3,
+    0x23, 0xf8, 0x47, 0xf6, 0x4, 0xdf, 0xd7, 0x0,
+
+    /* U+0066 "f" */
+    0x0, 0x2, 0xcf, 0xff, 0x0, 0xa, 0xd5, 0x54,
+    0x0, 0xc, 0x90, 0x0, 0x1, 0x1c, 0x91, 0x10,
+    0x2f, 0xff, 0xff, 0xff, 0x4, 0x4d, 0xa4, 0x43,
+    0x0, 0xc, 0x90, 0x0, 0x0, 0xc, 0x90, 0x0,
+    0x0, 0xc, 0x90, 0x0, 0x0, 0xc, 0x90, 0x0,
+    0x0, 0xc, 0x90, 0x0, 0x0, 0xc, 0x90, 0x0,
+
+    /* U+0067 "g" */
+    0x7, 0xee, 0x7b, 0x94, 0xf9, 0x4a, 0xe9, 0x9c,
+    0x0, 0xe, 0x9a, 0xa0, 0x0, 0xb9, 0xba, 0x0,
+    0xb, 0x99, 0xb0, 0x0, 0xd9, 0x6f, 0x40, 0x6f,
+    0x90, 0xaf, 0xfb, 0xc9, 0x0, 0x12, 0xc, 0x90,
+    0x0, 0x0, 0xd8, 0x2, 0x55, 0x9f, 0x40, 0x9f,
+    0xfd, 0x60,
+
+    /* U+0068 "h" */
+    0xab, 0x0, 0x0, 0xa, 0xb0, 0x0, 0x0, 0xab,
+    0x0, 0x0, 0xa, 0xb8, 0xee, 0x70, 0xae, 0x94,
+    0x9f, 0x4a, 0xe0, 0x0, 0xd9, 0xab, 0x0, 0xb,
+    0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0, 0xb, 0xaa,
+    0xb0, 0x0, 0xba, 0xab, 0x0, 0xb, 0xaa, 0xb0,
+    0x0, 0xba,
+
+    /* U+0069 "i" */
+    0x0, 0x2e, 0x90, 0x0, 0x0, 0x3f, 0x90, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x6f, 0xff, 0x80, 0x0, 0x25, 0x5d, 0x80, 0x0,
+    0x0, 0xc, 0x80, 0x0, 0x0, 0xc, 0x80, 0x0,
+    0x0, 0xc, 0x80, 0x0, 0x0, 0xc, 0x80, 0x0,
+    0x0, 0xc, 0x80, 0x0, 0x35, 0x5d, 0xb5, 0x51,
+    0xbf, 0xff, 0xff, 0xf5,
+
+    /* U+006A "j" */
+    0x0, 0x2, 0xf8, 0x0, 0x3, 0xf9, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0xbf, 0xff, 0xf8, 0x35,
+    0x55, 0xe8, 0x0, 0x0, 0xd8, 0x0, 0x0, 0xd8,
+    0x0, 0x0, 0xd8, 0x0, 0x0, 0xd8, 0x0, 0x0,
+    0xd8, 0x0, 0x0, 0xd8, 0x0, 0x0, 0xd8, 0x0,
+    0x1, 0xf6, 0x35, 0x5c, 0xe1, 0xaf, 0xfb, 0x20,
+
+    /* U+006B "k" */
+    0x8d, 0x0, 0x0, 0x0, 0x8d, 0x0, 0x0, 0x0,
+    0x8d, 0x0, 0x0, 0x0, 0x8d, 0x0, 0x9, 0xe0,
+    0x8d, 0x0, 0x3f, 0x50, 0x8d, 0x0, 0xcc, 0x0,
+    0x8d, 0x5, 0xf3, 0x0, 0x8f, 0xff, 0xb0, 0x0,
+    0x8d, 0x37, 0xf3, 0x0, 0x8d, 0x0, 0xcc, 0x0,
+    0x8d, 0x0, 0x2f, 0x70, 0x8d, 0x0, 0x8, 0xf1,
+
+    /* U+006C "l" */
+    0x8f, 0xff, 0xa0, 0x0, 0x2, 0x55, 0xca, 0x0,
+    0x0, 0x0, 0xb, 0xa0, 0x0, 0x0, 0x0, 0xba,
+    0x0, 0x0, 0x0, 0xb, 0xa0, 0x0, 0x0, 0x0,
+    0xba, 0x0, 0x0, 0x0, 0xb, 0xa0, 0x0, 0x0,
+    0x0, 0xba, 0x0, 0x0, 0x0, 0xb, 0xa0, 0x0,
+    0x0, 0x0, 0xaa, 0x0, 0x0, 0x0, 0x7, 0xe6,
+    0x55, 0x10, 0x0, 0xa, 0xff, 0xf4,
+
+    /* U+006D "m" */
+    0x1f, 0x9f, 0x7a, 0xf6, 0x1, 0xf5, 0x4f, 0x45,
+    0xf0, 0x1f, 0x21, 0xf1, 0x2f, 0x11, 0xf2, 0x1f,
+    0x12, 0xf1, 0x1f, 0x21, 0xf1, 0x2f, 0x11, 0xf2,
+    0x1f, 0x12, 0xf1, 0x1f, 0x21, 0xf1, 0x2f, 0x11,
+    0xf2, 0x1f, 0x12, 0xf1, 0x1f, 0x21, 0xf1, 0x2f,
+    0x10,
+
+    /* U+006E "n" */
+    0xab, 0x8f, 0xe7, 0xa, 0xe7, 0x16, 0xf4, 0xad,
+    0x0, 0xc, 0x9a, 0xb0, 0x0, 0xba, 0xab, 0x0,
+    0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0, 0xb,
+    0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0, 0xb, 0xa0,
+
+    /* U+006F "o" */
+    0x5, 0xdf, 0xd5, 0x3, 0xf9, 0x59, 0xf3, 0x9c,
+    0x0, 0xc, 0x9b, 0x90, 0x0, 0x9b, 0xb9, 0x0,
+    0x9, 0xbb, 0x90, 0x0, 0x9b, 0x9c, 0x0, 0xc,
+    0x93, 0xf9, 0x59, 0xf3, 0x5, 0xdf, 0xd5, 0x0,
+
+    /* U+0070 "p" */
+    0xab, 0x8e, 0xe7, 0xa, 0xe7, 0x25, 0xf4, 0xad,
+    0x0, 0xb, 0x9a, 0xb0, 0x0, 0xaa, 0xab, 0x0,
+    0xa, 0xba, 0xb0, 0x0, 0xaa, 0xae, 0x0, 0xc,
+    0x9a, 0xda, 0x48, 0xf4, 0xab, 0x7e, 0xe7, 0xa,
+    0xb0, 0x0, 0x0, 0xab, 0x0, 0x0, 0xa, 0xb0,
+    0x0, 0x0,
+
+    /* U+0071 "q" */
+    0x7, 0xee, 0x7b, 0xa4, 0xf8, 0x4a, 0xea, 0x9c,
+    0x0, 0xe, 0xaa, 0xa0, 0x0, 0xba, 0xba, 0x0,
+    0xb, 0xaa, 0xa0, 0x0, 0xba, 0x9c, 0x0, 0xe,
+    0xa4, 0xf8, 0x49, 0xda, 0x7, 0xee, 0x7b, 0xa0,
+    0x0, 0x0, 0xba, 0x0, 0x0, 0xb, 0xa0, 0x0,
+    0x0, 0xba,
+
+    /* U+0072 "r" */
+    0x5f, 0x4d, 0xfa, 0x15, 0xf9, 0x23, 0xe9, 0x5f,
+    0x20, 0x7, 0xd5, 0xf0, 0x0, 0x5c, 0x5f, 0x0,
+    0x0, 0x5, 0xf0, 0x0, 0x0, 0x5f, 0x0, 0x0,
+    0x5, 0xf0, 0x0, 0x0, 0x5f, 0x0, 0x0, 0x0,
+
+    /* U+0073 "s" */
+    0x8, 0xef, 0xe7, 0x6, 0xf6, 0x36, 0xf5, 0x9c,
+    0x0, 0x3, 0x26, 0xf8, 0x52, 0x0, 0x8, 0xdf,
+    0xfd, 0x10, 0x0, 0x3, 0xe8, 0x55, 0x0, 0xa,
+    0xa7, 0xf6, 0x46, 0xf7, 0x9, 0xef, 0xe9, 0x0,
+
+    /* U+0074 "t" */
+    0x0, 0x7, 0x30, 0x0, 0x0, 0xe, 0x60, 0x0,
+    0x0, 0xe, 0x60, 0x0, 0x4f, 0xff, 0xff, 0xfc,
+    0x15, 0x5f, 0x95, 0x53, 0x0, 0xe, 0x60, 0x0,
+    0x0, 0xe, 0x60, 0x0, 0x0, 0xe, 0x60, 0x0,
+    0x0, 0xe, 0x60, 0x0, 0x0, 0xe, 0x70, 0x0,
+    0x0, 0xb, 0xc5, 0x53, 0x0, 0x2, 0xdf, 0xfb,
+
+    /* U+0075 "u" */
+    0xab, 0x0, 0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab,
+    0x0, 0xb, 0xaa, 0xb0, 0x0, 0xba, 0xab, 0x0,
+    0xb, 0xaa, 0xb0, 0x0, 0xba, 0x8d, 0x0, 0xd,
+    0x82, 0xf9, 0x4a, 0xf2, 0x4, 0xdf, 0xc4, 0x0,
+
+    /* U+0076 "v" */
+    0xf, 0x60, 0x0, 0x6f, 0x0, 0xbb, 0x0, 0xa,
+    0xb0, 0x6, 0xf0, 0x0, 0xf6, 0x0, 0x1f, 0x40,
+    0x4f, 0x10, 0x0, 0xc9, 0x9, 0xc0, 0x0, 0x7,
+    0xe0, 0xd7, 0x0, 0x0, 0x2f, 0x5f, 0x20, 0x0,
+    0x0, 0xdd, 0xd0, 0x0, 0x0, 0x8, 0xf8, 0x0,
+    0x0,
+
+    /* U+0077 "w" */
+    0x7b, 0x4, 0xf4, 0xa, 0x74, 0xd0, 0x6e, 0x60,
+    0xc4, 0x2f, 0x9, 0xa9, 0xe, 0x20, 0xf1, 0xb6,
+    0xb0, 0xf0, 0xd, 0x3e, 0x1e, 0x3d, 0x0, 0xb6,
+    0xd0, 0xe6, 0xa0, 0x9, 0xbb, 0xb, 0xa8, 0x0,
+    0x6e, 0x80, 0x9e, 0x50, 0x4, 0xf6, 0x7, 0xf3,
+    0x0,
+
+    /* U+0078 "x" */
+    0xb, 0xc0, 0x0, 0xcc, 0x0, 0x2f, 0x60, 0x6f,
+    0x20, 0x0, 0x8e, 0x2e, 0x80, 0x0, 0x0, 0xde,
+    0xd0, 0x0, 0x0, 0x7, 0xf8, 0x0, 0x0, 0x1,
+    0xfb, 0xf1, 0x0, 0x0, 0xad, 0xd, 0xa0, 0x0,
+    0x4f, 0x30, 0x3f, 0x40, 0xe, 0xa0, 0x0, 0xae,
+    0x0,
+
+    /* U+0079 "y" */
+    0xf, 0x70, 0x0, 0x6f, 0x0, 0xac, 0x0, 0xb,
+    0xa0, 0x4, 0xf2, 0x1, 0xf5, 0x0, 0xe, 0x70,
+    0x5f, 0x0, 0x0, 0x8d, 0xb, 0xa0, 0x0, 0x3,
+    0xf3, 0xf4, 0x0, 0x0, 0xd, 0xce, 0x0, 0x0,
+    0x0, 0x7f, 0x90, 0x0, 0x0, 0x3, 0xf4, 0x0,
+    0x0, 0x0, 0x7e, 0x0, 0x0, 0x0, 0xc, 0x90,
+    0x0, 0x0, 0x2, 0xf3, 0x0, 0x0,
+
+    /* U+007A "z" */
+    0x8f, 0xff, 0xff, 0x72, 0x55, 0x58, 0xf5, 0x0,
+    0x0, 0xda, 0x0, 0x0, 0xad, 0x0, 0x0, 0x6f,
+    0x30, 0x0, 0x2f, 0x60, 0x0, 0xd, 0xa0, 0x0,
+    0x8, 0xf5, 0x55, 0x53, 0xaf, 0xff, 0xff, 0xa0,
+
+    /* U+00B0 "°" */
+    0xa, 0xda, 0x8, 0x80, 0x88, 0xb4, 0x4, 0xb8,
+    0x90, 0x98, 0xa, 0xea, 0x0
+};
+
+
+/*---------------------
+ *  GLYPH DESCRIPTION
+ *--------------------*/
+
+static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {
+    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
+    {.bitmap_index = 0, .adv_w = 144, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 0, .adv_w = 144, .box_w = 3, .box_h = 12, .ofs_x = 3, .ofs_y = 0},
+    {.bitmap_index = 18, .adv_w = 144, .box_w = 5, .box_h = 5, .ofs_x = 2, .ofs_y = 7},
+    {.bitmap_index = 31, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 85, .adv_w = 144, .box_w = 7, .box_h = 16, .ofs_x = 1, .ofs_y = -2},
+    {.bitmap_index = 141, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 195, .adv_w = 144, .box_w = 10, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 255, .adv_w = 144, .box_w = 3, .box_h = 5, .ofs_x = 3, .ofs_y = 7},
+    {.bitmap_index = 263, .adv_w = 144, .box_w = 6, .box_h = 16, .ofs_x = 2, .ofs_y = -2},
+    {.bitmap_index = 311, .adv_w = 144, .box_w = 6, .box_h = 16, .ofs_x = 1, .ofs_y = -2},
+    {.bitmap_index = 359, .adv_w = 144, .box_w = 9, .box_h = 9, .ofs_x = 0, .ofs_y = 1},
+    {.bitmap_index = 400, .adv_w = 144, .box_w = 9, .box_h = 8, .ofs_x = 0, .ofs_y = 1},
+    {.bitmap_index = 436, .adv_w = 144, .box_w = 3, .box_h = 5, .ofs_x = 3, .ofs_y = -3},
+    {.bitmap_index = 444, .adv_w = 144, .box_w = 5, .box_h = 3, .ofs_x = 2, .ofs_y = 4},
+    {.bitmap_index = 452, .adv_w = 144, .box_w = 3, .box_h = 3, .ofs_x = 3, .ofs_y = 0},
+    {.bitmap_index = 457, .adv_w = 144, .box_w = 7, .box_h = 15, .ofs_x = 1, .ofs_y = -2},
+    {.bitmap_index = 510, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 552, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 600, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 642, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 684, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 726, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 768, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 822, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 870, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 924, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 978, .adv_w = 144, .box_w = 3, .box_h = 9, .ofs_x = 3, .ofs_y = 0},
+    {.bitmap_index = 992, .adv_w = 144, .box_w = 3, .box_h = 12, .ofs_x = 3, .ofs_y = -3},
+    {.bitmap_index = 1010, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 1},
+    {.bitmap_index = 1042, .adv_w = 144, .box_w = 7, .box_h = 7, .ofs_x = 1, .ofs_y = 2},
+    {.bitmap_index = 1067, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 1},
+    {.bitmap_index = 1099, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1141, .adv_w = 144, .box_w = 9, .box_h = 15, .ofs_x = 0, .ofs_y = -3},
+    {.bitmap_index = 1209, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 1263, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1305, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1347, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1389, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1431, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1473, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1515, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1557, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1599, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 1647, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1695, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1743, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1785, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1827, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1869, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 1917, .adv_w = 144, .box_w = 7, .box_h = 15, .ofs_x = 1, .ofs_y = -3},
+    {.bitmap_index = 1970, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2018, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2060, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2114, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2156, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2210, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2264, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2318, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2372, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2414, .adv_w = 144, .box_w = 4, .box_h = 17, .ofs_x = 3, .ofs_y = -3},
+    {.bitmap_index = 2448, .adv_w = 144, .box_w = 7, .box_h = 15, .ofs_x = 1, .ofs_y = -2},
+    {.bitmap_index = 2501, .adv_w = 144, .box_w = 4, .box_h = 17, .ofs_x = 2, .ofs_y = -3},
+    {.bitmap_index = 2535, .adv_w = 144, .box_w = 7, .box_h = 7, .ofs_x = 1, .ofs_y = 5},
+    {.bitmap_index = 2560, .adv_w = 144, .box_w = 9, .box_h = 3, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 2574, .adv_w = 144, .box_w = 4, .box_h = 3, .ofs_x = 2, .ofs_y = 10},
+    {.bitmap_index = 2580, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2612, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2654, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2686, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2728, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2760, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 2808, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = -3},
+    {.bitmap_index = 2850, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2892, .adv_w = 144, .box_w = 8, .box_h = 13, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 2944, .adv_w = 144, .box_w = 6, .box_h = 16, .ofs_x = 1, .ofs_y = -3},
+    {.bitmap_index = 2992, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3040, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3094, .adv_w = 144, .box_w = 9, .box_h = 9, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3135, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3167, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3199, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = -3},
+    {.bitmap_index = 3241, .adv_w = 144, .box_w = 7, .box_h = 12, .ofs_x = 1, .ofs_y = -3},
+    {.bitmap_index = 3283, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3315, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3347, .adv_w = 144, .box_w = 8, .box_h = 12, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3395, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3427, .adv_w = 144, .box_w = 9, .box_h = 9, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3468, .adv_w = 144, .box_w = 9, .box_h = 9, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3509, .adv_w = 144, .box_w = 9, .box_h = 9, .ofs_x = 0, .ofs_y = 0},
+    {.bitmap_index = 3550, .adv_w = 144, .box_w = 9, .box_h = 12, .ofs_x = 0, .ofs_y = -3},
+    {.bitmap_index = 3604, .adv_w = 144, .box_w = 7, .box_h = 9, .ofs_x = 1, .ofs_y = 0},
+    {.bitmap_index = 3636, .adv_w = 144, .box_w = 5, .box_h = 5, .ofs_x = 2, .ofs_y = 7}
+};
+
+/*---------------------
+ *  CHARACTER MAPPING
+ *--------------------*/
+
+
+
+/*Collect the unicode lists and glyph_id offsets*/
+static const lv_font_fmt_txt_cmap_t cmaps[] =
+{
+    {
+        .range_start = 32, .range_length = 91, .glyph_id_start = 1,
+        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    },
+    {
+        .range_start = 176, .range_length = 1, .glyph_id_start = 92,
+        .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY
+    }
+};
+
+
+
+/*--------------------
+ *  ALL CUSTOM DATA
+ *--------------------*/
+
+#if LVGL_VERSION_MAJOR == 8
+/*Store all the custom data of the font*/
+static  lv_font_fmt_txt_glyph_cache_t cache;
+#endif
+
+#if LVGL_VERSION_MAJOR >= 8
+static const lv_font_fmt_txt_dsc_t font_dsc = {
+#else
+static lv_font_fmt_txt_dsc_t font_dsc = {
+#endif
+    .glyph_bitmap = glyph_bitmap,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = NULL,
+    .kern_scale = 0,
+    .cmap_num = 2,
+    .bpp = 4,
+    .kern_classes = 0,
+    .bitmap_format = 0,
+#if LVGL_VERSION_MAJOR == 8
+    .cache = &cache
+#endif
+};
+
+
+
+/*-----------------
+ *  PUBLIC FONT
+ *----------------*/
+
+/*Initialize a public general font descriptor*/
+#if LVGL_VERSION_MAJOR >= 8
+const lv_font_t jetbrains_mono_16 = {
+#else
+lv_font_t jetbrains_mono_16 = {
+#endif
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,    /*Function pointer to get glyph's data*/
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,    /*Function pointer to get glyph's bitmap*/
+    .line_height = 17,          /*The maximum line height required by the font*/
+    .base_line = 3,             /*Baseline measured from the bottom of the line*/
+#if !(LVGL_VERSION_MAJOR == 6 && LVGL_VERSION_MINOR == 0)
+    .subpx = LV_FONT_SUBPX_NONE,
+#endif
+#if LV_VERSION_CHECK(7, 4, 0) || LVGL_VERSION_MAJOR >= 8
+    .underline_position = -2,
+    .underline_thickness = 1,
+#endif
+    .dsc = &font_dsc,          /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */
+#if LV_VERSION_CHECK(8, 2, 0) || LVGL_VERSION_MAJOR >= 9
+    .fallback = NULL,
+#endif
+    .user_data = NULL,
+};
+
+
+
+#endif /*#if JETBRAINS_MONO_16*/
+
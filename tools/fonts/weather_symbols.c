@@ -0,0 +1,238 @@
+/*******************************************************************************
+ * Size: 15 px
+ * Bpp: 4
+ * Opts: --bpp 4 --size 15 --no-compress --font fa-solid-900.ttf --range 61713,61634,63293,63296,63322,62172,61507 --format lvgl -o weather_symbols.c
+ ******************************************************************************/
+
+#ifdef LV_LVGL_H_INCLUDE_SIMPLE
+#include "lvgl.h"
+#else
+#include "lvgl.h"
+#endif
+
+#ifndef WEATHER_SYMBOLS
+#define WEATHER_SYMBOLS 1
+#endif
+
+#if WEATHER_SYMBOLS
+
+/*-----------------
+ *    BITMAPS
+ *----------------*/
+
+/*Store the image of the glyphs*/
+static LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap[] = {
+    /* U+F043 "" */
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0xa,
+    0xe0, 0x0, 0x0, 0x0, 0x1, 0xff, 0x50, 0x0,
+    0x0, 0x0, 0x7f, 0xfc, 0x0, 0x0, 0x0, 0x1e,
+    0xff, 0xf5, 0x0, 0x0, 0x9, 0xff, 0xff, 0xd0,
+    0x0, 0x4, 0xff, 0xff, 0xff, 0x90, 0x0, 0xdf,
+    0xff, 0xff, 0xff, 0x40, 0x7f, 0xff, 0xff, 0xff,
+    0xfc, 0xd, 0xff, 0xff, 0xff, 0xff, 0xf2, 0xff,
+    0x7f, 0xff, 0xff, 0xff, 0x4e, 0xf1, 0xff, 0xff,
+    0xff, 0xf3, 0xaf, 0x75, 0xef, 0xff, 0xff, 0x2,
+    0xff, 0x82, 0x8f, 0xff, 0x70, 0x5, 0xff, 0xff,
+    0xff, 0x90, 0x0, 0x2, 0x9d, 0xda, 0x40, 0x0,
+
+    /* U+F0C2 "" */
+    0x0, 0x0, 0x0, 0x2, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x2, 0xbf, 0xff, 0xb1, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x2, 0xef, 0xff, 0xff,
+    0xe2, 0x33, 0x0, 0x0, 0x0, 0x0, 0xbf, 0xff,
+    0xff, 0xff, 0xff, 0xfd, 0x20, 0x0, 0x0, 0x1f,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x0, 0x0,
+    0x3, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xe0,
+    0x0, 0x6, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xfe, 0x20, 0x5, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0x80, 0xcf, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0x4f, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfa, 0xef,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xb9, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xf7, 0x1d, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xfd, 0x10, 0x19, 0xef, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xe9, 0x10,
+
+    /* U+F111 "" */
+    0x0, 0x0, 0x39, 0xcd, 0xc9, 0x30, 0x0, 0x0,
+    0x0, 0xaf, 0xff, 0xff, 0xff, 0xa0, 0x0, 0x0,
+    0xcf, 0xff, 0xff, 0xff, 0xff, 0xc0, 0x0, 0xaf,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xa0, 0x2f, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0x28, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xf8, 0xbf, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xab, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xfb, 0xaf, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xa6, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xf6, 0x1f, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0x10, 0x7f, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x70, 0x0, 0x9f, 0xff, 0xff, 0xff, 0xff,
+    0x90, 0x0, 0x0, 0x6e, 0xff, 0xff, 0xfe, 0x60,
+    0x0, 0x0, 0x0, 0x5, 0x89, 0x85, 0x0, 0x0,
+    0x0,
+
+    /* U+F2DC "" */
+    0x0, 0x0, 0x0, 0x10, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x2, 0xfb, 0x10, 0x0, 0x0, 0x0, 0x0,
+    0xbd, 0xfe, 0xf5, 0x0, 0x0, 0x0, 0x74, 0x3e,
+    0xff, 0xb0, 0x83, 0x0, 0x4b, 0xdb, 0x4, 0xfd,
+    0x1, 0xfa, 0xb0, 0x9f, 0xff, 0x12, 0xfc, 0x6,
+    0xff, 0xf3, 0x4e, 0xff, 0xe8, 0xfd, 0xaf, 0xff,
+    0xb1, 0x6b, 0x78, 0xff, 0xff, 0xfd, 0x69, 0xc1,
+    0x0, 0x0, 0x7f, 0xff, 0xe2, 0x0, 0x0, 0x8f,
+    0xbc, 0xff, 0xff, 0xff, 0xad, 0xf2, 0x3e, 0xff,
+    0xb4, 0xfc, 0x6e, 0xff, 0xb0, 0xaf, 0xfe, 0x2,
+    0xfc, 0x4, 0xff, 0xf4, 0x27, 0xca, 0x6, 0xfe,
+    0x20, 0xf8, 0x70, 0x0, 0x32, 0x6f, 0xff, 0xe1,
+    0x41, 0x0, 0x0, 0x0, 0x9a, 0xfd, 0xc3, 0x0,
+    0x0, 0x0, 0x0, 0x1, 0xd9, 0x0, 0x0, 0x0,
+
+    /* U+F73D "" */
+    0x0, 0x0, 0x34, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x1, 0xcf, 0xff, 0x40, 0x43, 0x0, 0x0, 0x0,
+    0xbf, 0xff, 0xff, 0xdf, 0xf9, 0x0, 0x0, 0xf,
+    0xff, 0xff, 0xff, 0xff, 0xf1, 0x0, 0x4, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0x93, 0x5, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xf5, 0xdf, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xdf, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xaf, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xa1, 0xaf, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xa1, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x1, 0x0, 0x0, 0x20, 0x0,
+    0x1, 0x0, 0x0, 0xb5, 0x0, 0x1e, 0x10, 0x5,
+    0xb0, 0x0, 0x4f, 0xd0, 0x9, 0xf9, 0x0, 0xdf,
+    0x40, 0x8, 0xff, 0x20, 0xdf, 0xd0, 0x2f, 0xf8,
+    0x0, 0x2c, 0x90, 0x6, 0xd6, 0x0, 0x9c, 0x20,
+
+    /* U+F740 "" */
+    0x0, 0x0, 0x34, 0x10, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x1c, 0xff, 0xf5, 0x4, 0x40, 0x0, 0x0,
+    0x0, 0xbf, 0xff, 0xff, 0xdf, 0xfa, 0x0, 0x0,
+    0x0, 0xff, 0xff, 0xff, 0xff, 0xff, 0x20, 0x0,
+    0x3, 0xff, 0xff, 0xff, 0xff, 0xff, 0x93, 0x0,
+    0x5f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x50,
+    0xdf, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xe0,
+    0xef, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xf0,
+    0x9f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xa0,
+    0x1a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x10,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x50, 0x14, 0x3, 0x30, 0x41, 0x6, 0x0,
+    0x7, 0x90, 0xa6, 0xd, 0x31, 0xe1, 0x3d, 0x0,
+    0x1e, 0x14, 0xd0, 0x7a, 0xa, 0x70, 0xc4, 0x0,
+    0xa7, 0xd, 0x41, 0xe1, 0x3d, 0x6, 0xb0, 0x0,
+    0x80, 0x7, 0x2, 0x50, 0x43, 0x6, 0x20, 0x0,
+
+    /* U+F75A "" */
+    0x0, 0x0, 0x0, 0x32, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x0, 0x8f, 0x70, 0x0, 0x0, 0x0, 0x0,
+    0x0, 0x8f, 0xf2, 0x0, 0x0, 0x0, 0x0, 0x1,
+    0xef, 0xf5, 0x0, 0x0, 0x0, 0x28, 0xae, 0xff,
+    0xfa, 0x20, 0x0, 0x0, 0xef, 0xff, 0xff, 0xff,
+    0xf1, 0x0, 0x1, 0xff, 0xff, 0xff, 0xff, 0xf3,
+    0x0, 0x8, 0xff, 0xb3, 0x33, 0xbf, 0xf9, 0x10,
+    0xbf, 0xff, 0x3b, 0xda, 0x4f, 0xff, 0xc0, 0xff,
+    0xff, 0x1f, 0xf9, 0x3b, 0xff, 0xf1, 0xcf, 0xfe,
+    0x1f, 0xfb, 0x82, 0xcf, 0xd0, 0x1b, 0xeb, 0x3f,
+    0xff, 0xf1, 0xcb, 0x20, 0x0, 0x0, 0x15, 0x9f,
+    0x70, 0x0, 0x0, 0x0, 0x0, 0x0, 0x8d, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0xb4, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x60, 0x0, 0x0, 0x0
+};
+
+
+/*---------------------
+ *  GLYPH DESCRIPTION
+ *--------------------*/
+
+static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {
+    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,
+    {.bitmap_index = 0, .adv_w = 165, .box_w = 11, .box_h = 16, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 88, .adv_w = 300, .box_w = 19, .box_h = 14, .ofs_x = 0, .ofs_y = -1},
+    {.bitmap_index = 221, .adv_w = 240, .box_w = 15, .box_h = 15, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 334, .adv_w = 210, .box_w = 14, .box_h = 16, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 446, .adv_w = 240, .box_w = 15, .box_h = 16, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 566, .adv_w = 240, .box_w = 16, .box_h = 16, .ofs_x = 0, .ofs_y = -2},
+    {.bitmap_index = 694, .adv_w = 210, .box_w = 14, .box_h = 16, .ofs_x = 0, .ofs_y = -2}
+};
+
+/*---------------------
+ *  CHARACTER MAPPING
+ *--------------------*/
+
+static const uint16_t unicode_list_0[] = {
+    0x0, 0x7f, 0xce, 0x299, 0x6fa, 0x6fd, 0x717
+};
+
+/*Collect the unicode lists and glyph_id offsets*/
+static const lv_font_fmt_txt_cmap_t cmaps[] =
+{
+    {
+        .range_start = 61507, .range_length = 1816, .glyph_id_start = 1,
+        .unicode_list = unicode_list_0, .glyph_id_ofs_list = NULL, .list_length = 7, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY
+    }
+};
+
+
+
+/*--------------------
+ *  ALL CUSTOM DATA
+ *--------------------*/
+
+#if LVGL_VERSION_MAJOR == 8
+/*Store all the custom data of the font*/
+static  lv_font_fmt_txt_glyph_cache_t cache;
+#endif
+
+#if LVGL_VERSION_MAJOR >= 8
+static const lv_font_fmt_txt_dsc_t font_dsc = {
+#else
+static lv_font_fmt_txt_dsc_t font_dsc = {
+#endif
+    .glyph_bitmap = glyph_bitmap,
+    .glyph_dsc = glyph_dsc,
+    .cmaps = cmaps,
+    .kern_dsc = NULL,
+    .kern_scale = 0,
+    .cmap_num = 1,
+    .bpp = 4,
+    .kern_classes = 0,
+    .bitmap_format = 0,
+#if LVGL_VERSION_MAJOR == 8
+    .cache = &cache
+#endif
+};
+
+
+
+/*-----------------
+ *  PUBLIC FONT
+ *----------------*/
+
+/*Initialize a public general font descriptor*/
+#if LVGL_VERSION_MAJOR >= 8
+const lv_font_t weather_symbols = {
+#else
+lv_font_t weather_symbols = {
+#endif
+    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,    /*Function pointer to get glyph's data*/
+    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,    /*Function pointer to get glyph's bitmap*/
+    .line_height = 16,          /*The maximum line height required by the font*/
+    .base_line = 2,             /*Baseline measured from the bottom of the line*/
+#if !(LVGL_VERSION_MAJOR == 6 && LVGL_VERSION_MINOR == 0)
+    .subpx = LV_FONT_SUBPX_NONE,
+#endif
+#if LV_VERSION_CHECK(7, 4, 0) || LVGL_VERSION_MAJOR >= 8
+    .underline_position = -1,
+    .underline_thickness = 1,
+#endif
+    .dsc = &font_dsc,          /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */
+#if LV_VERSION_CHECK(8, 2, 0) || LVGL_VERSION_MAJOR >= 9
+    .fallback = NULL,
+#endif
+    .user_data = NULL,
+};
+
+
+
+#endif /*#if WEATHER_SYMBOLS*/
+
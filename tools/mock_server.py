@@ -0,0 +1,237 @@
+#!/usr/bin/env python3
+"""
+Local stand-in for the Open-Meteo API, to measure fetches without the internet.
+
+    python tools/mock_server.py --make-ca          # once: CA + certificate for api.open-meteo.com
+    python tools/mock_server.py --port 8443        # HTTPS, build with API_MOCK 1 and API_MOCK_IP set
+    python tools/mock_server.py --plain --port 8080
+
+--make-ca writes the key material to tools/mock_ca and the CA as main/tls_ca_mock.h,
+which tls_ca.h pins instead of the real roots when API_MOCK is 1. The certificate
+is issued for the real host name, so SNI and the name check run as on the real API.
+
+Each request is logged with whether the TLS session was resumed and how many
+bytes went out. The body is a made up forecast that --hours pads with hourly data,
+or with --replay the "REC ... HTTP" lines of a RECORD_SESSION log, one per request
+in the order they were recorded. The last one is repeated once the log runs out.
+
+    python tools/mock_server.py --plain --replay session.log
+
+    python tools/mock_server.py --gzip --hours 168           # compressed when asked for
+    python tools/mock_server.py --gzip --gzip-bits 15 --chunked
+
+Compare the "Body:" metrics line of a build with API_GZIP 1 and one with API_GZIP 0.
+
+Both providers of weather_api.h are simulated with one instance each, slowed down and
+made to fail on purpose to see the hedged request at work:
+
+    python tools/mock_server.py --port 8443 --gzip --delay-ms 150 --jitter-ms 80 --slow-rate 0.1 --slow-ms 4000
+    python tools/mock_server.py --port 8444 --delay-ms 300 --jitter-ms 100 --fail-rate 0.02
+
+The "Latency primary" and "Latency answer" metrics lines give the percentiles with and without the hedge.
+"""
+
+import argparse
+import json
+import os
+import random
+import re
+import ssl
+import subprocess
+import sys
+import threading
+import time
+import zlib
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+CA_DIR = os.path.join(ROOT, "tools", "mock_ca")
+CA_HEADER = os.path.join(ROOT, "main", "tls_ca_mock.h")
+API_HOST = "api.open-meteo.com"
+REC_RE = re.compile(r"REC \d+ HTTP (.*)$")
+
+
+def make_ca():
+    """Creates an EC CA and a server certificate for API_HOST signed by it."""
+    os.makedirs(CA_DIR, exist_ok=True)
+
+    def path(name):
+        return os.path.join(CA_DIR, name)
+
+    def openssl(*args):
+        subprocess.run(["openssl"] + list(args), check=True, capture_output=True)
+
+    openssl("ecparam", "-name", "prime256v1", "-genkey", "-noout", "-out", path("ca.key"))
+    openssl("req", "-x509", "-new", "-key", path("ca.key"), "-days", "3650", "-subj", "/CN=Weather Mock CA",
+            "-out", path("ca.pem"))
+    openssl("ecparam", "-name", "prime256v1", "-genkey", "-noout", "-out", path("server.key"))
+    openssl("req", "-new", "-key", path("server.key"), "-subj", "/CN=" + API_HOST, "-out", path("server.csr"))
+    with open(path("ext.cnf"), "w") as ext:
+        ext.write("subjectAltName=DNS:%s\n" % API_HOST)
+    openssl("x509", "-req", "-in", path("server.csr"), "-CA", path("ca.pem"), "-CAkey", path("ca.key"),
+            "-CAcreateserial", "-days", "825", "-extfile", path("ext.cnf"), "-out", path("server.pem"))
+
+    with open(path("ca.pem")) as pem:
+        lines = ['    "%s\\n"' % line for line in pem.read().strip().splitlines()]
+    with open(CA_HEADER, "w") as out:
+        out.write("//Written by tools/mock_server.py --make-ca, pinned when API_MOCK is 1\n")
+        out.write("static const char tls_ca_pem[] =\n%s;\n" % "\n".join(lines))
+    print("wrote %s and %s" % (CA_DIR, CA_HEADER))
+
+
+def made_up_body(days, hours):
+    body = {
+        "current": {"temperature_2m": 61.3, "precipitation": 0.02, "weather_code": 61},
+        "daily": {
+            "weather_code": [61, 3, 0][:days],
+            "temperature_2m_max": [64.1, 58.7, 66.0][:days],
+            "temperature_2m_min": [51.2, 47.9, 50.4][:days],
+        },
+    }
+    if hours:  # what a bigger request would bring, the device scans past it
+        body["hourly"] = {
+            "time": ["2024-06-%02dT%02d:00" % (1 + h // 24, h % 24) for h in range(hours)],
+            "temperature_2m": [round(55 + 10 * ((h % 24) / 24.0), 1) for h in range(hours)],
+            "precipitation": [0.0 if h % 7 else 0.01 for h in range(hours)],
+        }
+    return json.dumps(body, separators=(",", ":"))
+
+
+def gzip_body(body, bits):
+    """gzip with a chosen window, the device only keeps GZIP_WINDOW_BITS of history."""
+    packer = zlib.compressobj(9, zlib.DEFLATED, 16 + bits)
+    return packer.compress(body) + packer.flush()
+
+
+def replay_bodies(log):
+    bodies = []
+    with open(log, errors="replace") as src:
+        for line in src:
+            match = REC_RE.search(line.rstrip("\n"))
+            if match:
+                bodies.append(match.group(1).encode())
+    if not bodies:
+        sys.exit("no REC ... HTTP line in %s" % log)
+    return bodies
+
+
+class Handler(BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+    bodies = [b""]
+    served = 0
+    lock = threading.Lock()
+    gzip_bits = 0  # 0 never compresses
+    chunked = False
+    delay_ms = 0
+    jitter_ms = 0
+    slow_rate = 0.0
+    slow_ms = 0
+    fail_rate = 0.0
+
+    def wait(self):
+        """Holds the response back, sometimes much longer, like a loaded server."""
+        delay = self.delay_ms + random.uniform(0, self.jitter_ms)
+        if random.random() < self.slow_rate:
+            delay += self.slow_ms
+        time.sleep(delay / 1000.0)
+        return delay
+
+    def next_body(self):
+        """The recorded bodies in order, requests are handled on their own threads."""
+        with Handler.lock:
+            index = min(Handler.served, len(self.bodies) - 1)
+            Handler.served += 1
+        return index, self.bodies[index]
+
+    def do_GET(self):
+        if not self.path.startswith("/v1/forecast"):
+            self.send_error(404)
+            return
+        delay = self.wait()
+        if random.random() < self.fail_rate:
+            self.send_response(503)
+            self.send_header("Connection", "close")
+            self.send_header("Content-Length", "0")
+            self.end_headers()
+            self.close_connection = True
+            print("%s %s: 503 after %d ms" % (time.strftime("%H:%M:%S"), self.client_address[0], delay))
+            return
+        index, body = self.next_body()
+        json_len = len(body)
+        encoding = None
+        if self.gzip_bits and "gzip" in self.headers.get("Accept-Encoding", ""):
+            body = gzip_body(body, self.gzip_bits)
+            encoding = "gzip"
+        self.send_response(200)
+        self.send_header("Content-Type", "application/json")
+        self.send_header("Connection", "close")
+        if encoding:
+            self.send_header("Content-Encoding", encoding)
+        if self.chunked:
+            self.send_header("Transfer-Encoding", "chunked")
+            self.end_headers()
+            for i in range(0, len(body), 700):
+                part = body[i:i + 700]
+                self.wfile.write(b"%x\r\n%s\r\n" % (len(part), part))
+            self.wfile.write(b"0\r\n\r\n")
+        else:
+            self.send_header("Content-Length", str(len(body)))
+            self.end_headers()
+            self.wfile.write(body)
+        self.close_connection = True
+        resumed = getattr(self.connection, "session_reused", None)
+        tls = "plain" if resumed is None else ("resumed" if resumed else "full handshake")
+        print("%s %s: body %d/%d, %d bytes (%d JSON%s) after %d ms, %s" % (time.strftime("%H:%M:%S"),
+              self.client_address[0], index + 1, len(self.bodies), len(body), json_len, ", gzip" if encoding else "",
+              delay, tls))
+
+    def log_message(self, fmt, *args):
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--make-ca", action="store_true", help="create the CA and server certificate, then exit")
+    parser.add_argument("--port", type=int, default=8443)
+    parser.add_argument("--plain", action="store_true", help="serve HTTP instead of HTTPS")
+    parser.add_argument("--replay", help="serve the bodies recorded in this RECORD_SESSION log, in order")
+    parser.add_argument("--days", type=int, default=3, help="forecast days in the made up body")
+    parser.add_argument("--hours", type=int, default=0, help="hourly values padding the made up body")
+    parser.add_argument("--gzip", action="store_true", help="compress when the request accepts gzip")
+    parser.add_argument("--gzip-bits", type=int, default=12, help="deflate window bits, 9 to 15")
+    parser.add_argument("--chunked", action="store_true", help="send the body with chunked transfer encoding")
+    parser.add_argument("--delay-ms", type=int, default=0, help="wait this long before every response")
+    parser.add_argument("--jitter-ms", type=int, default=0, help="plus up to this much at random")
+    parser.add_argument("--slow-rate", type=float, default=0.0, help="share of responses that also wait --slow-ms")
+    parser.add_argument("--slow-ms", type=int, default=3000)
+    parser.add_argument("--fail-rate", type=float, default=0.0, help="share of requests answered with 503")
+    args = parser.parse_args()
+
+    if args.make_ca:
+        make_ca()
+        return 0
+
+    Handler.bodies = replay_bodies(args.replay) if args.replay else [made_up_body(args.days, args.hours).encode()]
+    Handler.gzip_bits = args.gzip_bits if args.gzip else 0
+    Handler.chunked = args.chunked
+    Handler.delay_ms = args.delay_ms
+    Handler.jitter_ms = args.jitter_ms
+    Handler.slow_rate = args.slow_rate
+    Handler.slow_ms = args.slow_ms
+    Handler.fail_rate = args.fail_rate
+    server = ThreadingHTTPServer(("0.0.0.0", args.port), Handler)
+    if not args.plain:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.maximum_version = ssl.TLSVersion.TLSv1_2  # same as the device, see tls_fetch.c
+        context.load_cert_chain(os.path.join(CA_DIR, "server.pem"), os.path.join(CA_DIR, "server.key"))
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+    print("serving %s on port %d" % ("HTTP" if args.plain else "HTTPS", args.port))
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
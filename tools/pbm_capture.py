@@ -0,0 +1,103 @@
+#!/usr/bin/env python3
+"""
+Pulls the PBM frames printed with CAPTURE_FRAMES out of a serial log
+and compares them against the golden images in tools/frames.
+
+    idf.py monitor | tee run.log
+    python tools/pbm_capture.py run.log
+    python tools/pbm_capture.py run.log --update    # after a deliberate UI change
+    python tools/pbm_capture.py run.log --out frames
+
+The frames come from the fixed list in timewarp_frames(), each is saved as
+<name>_page<page>.pbm. A golden image with no captured frame counts as a
+mismatch too, so a case dropped from the list is noticed. Exits 1 on any mismatch.
+"""
+
+import argparse
+import os
+import sys
+
+GOLDEN = os.path.join(os.path.dirname(os.path.abspath(__file__)), "frames")
+
+
+def read_frames(path):
+    frames = []
+    name = None
+    lines = []
+    with open(path, errors="replace") as log:
+        for raw in log:
+            line = raw.strip()
+            if line.startswith("PBM BEGIN"):
+                fields = line.split()
+                page = int(fields[2])
+                case = fields[3] if len(fields) > 3 else "frame_%03d" % len(frames)
+                name = "%s_page%d.pbm" % (case, page)
+                lines = []
+            elif line == "PBM END" and name is not None:
+                frames.append((name, "\n".join(lines) + "\n"))
+                name = None
+            elif name is not None:
+                lines.append(line)
+    return frames
+
+
+def diff_pixels(a, b):
+    rows_a = a.splitlines()[2:]
+    rows_b = b.splitlines()[2:]
+    if len(rows_a) != len(rows_b):
+        return -1
+    return sum(pa != pb for ra, rb in zip(rows_a, rows_b) for pa, pb in zip(ra, rb))
+
+
+def write_frames(folder, frames):
+    os.makedirs(folder, exist_ok=True)
+    for name, data in frames:
+        with open(os.path.join(folder, name), "w") as out:
+            out.write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("log")
+    parser.add_argument("--golden", default=GOLDEN, help="folder of golden frames, tools/frames by default")
+    parser.add_argument("--update", action="store_true", help="replace the golden frames with the captured ones")
+    parser.add_argument("--out", help="also write the captured frames to this folder")
+    args = parser.parse_args()
+
+    frames = read_frames(args.log)
+    if not frames:
+        print("no frames in %s, was CAPTURE_FRAMES set?" % args.log)
+        return 1
+    if args.out:
+        write_frames(args.out, frames)
+    if args.update:
+        write_frames(args.golden, frames)
+        print("%d golden frames written to %s" % (len(frames), args.golden))
+        return 0
+
+    failed = 0
+    captured = set()
+    for name, data in frames:
+        captured.add(name)
+        golden_path = os.path.join(args.golden, name)
+        if not os.path.exists(golden_path):
+            print("%s: no golden image" % name)
+            failed += 1
+            continue
+        with open(golden_path) as golden:
+            changed = diff_pixels(golden.read(), data)
+        if changed != 0:
+            print("%s: %s pixels differ" % (name, "size" if changed < 0 else changed))
+            failed += 1
+    if os.path.isdir(args.golden):
+        for name in sorted(os.listdir(args.golden)):
+            if name.endswith(".pbm") and name not in captured:
+                print("%s: not captured" % name)
+                failed += 1
+
+    print("%d frames, %d mismatches" % (len(frames), failed))
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+Pulls the pipeline traces printed with TRACE_ENABLE out of a serial log.
+
+    idf.py monitor | tee run.log
+    python tools/trace_capture.py run.log --out traces
+
+Each dump is saved as trace_<index>.json and can be opened in
+chrome://tracing or https://ui.perfetto.dev. With --summary the gap from
+each wake to the next flush end is printed as well. Events are parsed one
+line at a time, so other output that lands inside a dump is skipped.
+"""
+
+import argparse
+import json
+import os
+import sys
+
+
+def parse_event(line):
+    """One event of a dump, None for the array brackets or anything else that got into the log."""
+    try:
+        event = json.loads(line.rstrip(","))
+    except ValueError:
+        return None
+    return event if isinstance(event, dict) and "ph" in event else None
+
+
+def read_traces(path):
+    traces = []
+    events = None
+    skipped = 0
+    with open(path, errors="replace") as log:
+        for raw in log:
+            line = raw.strip()
+            if line == "TRACE BEGIN":
+                events = []
+            elif line == "TRACE END" and events is not None:
+                traces.append({"traceEvents": events})
+                events = None
+            elif events is not None and line not in ('{"traceEvents": [', "]}"):
+                event = parse_event(line)
+                if event is None:
+                    skipped += 1
+                else:
+                    events.append(event)
+    if skipped:
+        print("%d lines inside the traces were not events and were skipped" % skipped, file=sys.stderr)
+    return traces
+
+
+def wake_to_pixels(trace):
+    """Microseconds from every wake or HTTP response to the end of the next flush."""
+    events = sorted((e for e in trace["traceEvents"] if e["ph"] != "M"), key=lambda e: e["ts"])
+    gaps = []
+    start = None
+    for event in events:
+        if event["name"] in ("time wake", "http response") and start is None:
+            start = event
+        elif event["name"] == "flush" and event["ph"] == "E" and start is not None:
+            gaps.append((start["name"], event["ts"] - start["ts"]))
+            start = None
+    return gaps
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("log")
+    parser.add_argument("--out", default=".", help="folder to write the traces to")
+    parser.add_argument("--summary", action="store_true")
+    args = parser.parse_args()
+
+    traces = read_traces(args.log)
+    os.makedirs(args.out, exist_ok=True)
+    for index, trace in enumerate(traces):
+        path = os.path.join(args.out, "trace_%d.json" % index)
+        with open(path, "w") as out:
+            json.dump(trace, out)
+        print("%s: %d events" % (path, len(trace["traceEvents"])))
+        if args.summary:
+            for name, gap in wake_to_pixels(trace):
+                print("  %s -> pixels: %.1f ms" % (name, gap / 1000))
+    return 0 if traces else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())